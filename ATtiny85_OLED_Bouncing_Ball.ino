@@ -1,8 +1,21 @@
 #include <inttypes.h>
 #include "OLED.h"
+#include "Room.h"
+#include "Animation.h"
+#include "CellRenderer.h"
+#include "DisplayList.h"
+#include "FlightRecorder.h"
 #include "GlyphsOnQuarter.h"
+#include "Memory.h"
+#include "Overlay.h"
+#include "RegionScheduler.h"
+#include "RoomFlush.h"
+#include "SplashAnimation.h"
+#include "Telemetry.h"
+#include "TimingTuner.h"
 
 struct OLED_DEVICE {
+  using Controller = OLED::SSD1306;
   static constexpr uint8_t ADDRESS { 0x3C };
   static constexpr USI_TWI_Delay tHSTART { 0 };
   static constexpr USI_TWI_Delay tSSTOP { 0 };
@@ -12,49 +25,64 @@ struct OLED_DEVICE {
   static constexpr USI_TWI_Delay tPOST_TRANSFER { 0 };
 };
 
-// Terminology:
-// - "row" & "col" apply to the coarse grid defining the room
-// - "Y" and "X" refer to the rows and columns of actual pixels
-static uint8_t constexpr X_PER_COL = 4;
-static uint8_t constexpr Y_PER_ROW = 4;
-static uint8_t constexpr COLS = OLED::WIDTH / X_PER_COL;
-static uint8_t constexpr ROWS = OLED::HEIGHT / Y_PER_ROW;
+// Set to run the timing tuner instead of the game. It displays, for each delay
+// of fast mode timing in turn, the lowest percentage at which the panel
+// acknowledged everything, so that OLED_DEVICE can be replaced by the
+// corresponding I2C::TunedDevice.
+static bool constexpr CALIBRATE_I2C = false;
+
+// Set to show the contents of the flight recorder instead of running the game.
+static bool constexpr DUMP_RECORDER = false;
+static unsigned long constexpr RATE_SAMPLE_MS = 60000;
+
+// Set to measure the compose kernel of each cell geometry instead of running
+// the game, displaying cycles per pixel column for 2x2, 4x4, 8x8 and 4x8 cells.
+static bool constexpr BENCHMARK_GEOMETRIES = false;
+
+// Set to measure looking up walls instead of running the game, displaying the
+// cycles per lookup, to a tenth, from room_shape in program memory, from the
+// wall map in RAM, and for the loop around the lookups alone.
+static bool constexpr BENCHMARK_WALLS = false;
+
+// Set to stream frame statistics out of Telemetry::PIN, for host/telemetry_decode.
+static bool constexpr TELEMETRY = false;
+
+// Set to play the splash animation before the game starts. Animations are
+// encoded for windowing, and thus don't play on an SH1106.
+static bool constexpr SHOW_SPLASH = false;
+static_assert(!SHOW_SPLASH || OLED_DEVICE::Controller::WINDOWING, "the splash animation needs windowing");
+
+
+// Set to show a scene drawn from a display list before the game starts.
+static bool constexpr SHOW_SCENE = false;
+
+// Set to refresh only regions of the display as they are due, each at its own
+// rate, rather than the whole room each frame. Also shows frames per second.
+static bool constexpr REFRESH_REGIONS = false;
+static uint16_t constexpr BUS_BYTES_PER_FRAME = 128;
+
+// Set to have the ball knock down the inner walls it hits. Only the cells
+// knocked down are redrawn, as regions, so this needs REFRESH_REGIONS.
+static bool constexpr DESTRUCTIBLE_WALLS = false;
+static_assert(!DESTRUCTIBLE_WALLS || REFRESH_REGIONS, "knocked down walls are redrawn as regions only");
+
+static_assert(COLS * X_PER_COL == OLED::WIDTH && ROWS * Y_PER_ROW == OLED::HEIGHT, "room must fill the display");
 static uint8_t constexpr BYTES_PER_X = OLED::BYTES_PER_SEG;
-static uint8_t constexpr ROWS_PER_BYTE = 8 / Y_PER_ROW;
-
-static uint8_t ballY = 10 * Y_PER_ROW;
-static uint8_t ballX =  7 * X_PER_COL;
-static int8_t ballYDir = +1;
-static int8_t ballXDir = -2;
-
-static uint8_t constexpr ball_shape[X_PER_COL] = { 0x6, 0xF, 0xF, 0x6 }; // pixel columns per X
-
-static uint8_t const room_shape[ROWS * COLS] PROGMEM = {
-  1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 2 , 2, 2, 2, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 2, 2, 2, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 0, 0, 2, 2, 2, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 2, 2, 2, 2, 0, 0, 0 , 0, 2, 0, 0, 0, 0, 0, 2 , 2, 2, 2, 2, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 2, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
-  1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1,
-};
+using Cells = CellGeometry<X_PER_COL, Y_PER_ROW>;
+static uint8_t constexpr ROWS_PER_BYTE = Cells::ROWS_PER_BYTE;
 
-static uint8_t leftshift(uint8_t value, int8_t positions) {
-  return positions >= 0 ? (value << positions) : (value >> -positions);
-}
+static Ball ball = { 10 * Y_PER_ROW, 7 * X_PER_COL, +1, -2 };
+static WallMap walls;
 
-static uint8_t getWall(uint8_t row, uint8_t col) {
-  return pgm_read_byte(&room_shape[row * COLS + col]);
-}
+// Overlays composed into the room, if any.
+static Overlay* overlays[2];
+
+// Parts of the display refreshed at their own rate, if REFRESH_REGIONS.
+static RegionScheduler<4> regions;
+static uint8_t ball_region;
+static uint8_t heartbeat_region;
+static uint8_t status_region;
+static Overlay status { OLED::Quarter::A, X_PER_COL, Overlay::OVER_BALL, true, true };
 
 static void flashN(uint8_t number) {
   while (number >= 5) {
@@ -76,6 +104,8 @@ static void flashN(uint8_t number) {
 // Report an error while the display isn't set up.
 static void flashError(I2C::Status status) {
   if (status.error) {
+    Recorder::recordFault(status, ball.y, ball.x, ball.yDir, ball.xDir);
+    Recorder::flush();
     for (;;) {
       delay(1200);
       flashN(status.error);
@@ -85,106 +115,428 @@ static void flashError(I2C::Status status) {
   }
 }
 
-// Report an error while we think we can display it.
-static void displayError(I2C::Status status) {
-  if (status.error) {
-    auto chat = GlyphsOnQuarter<OLED_DEVICE> {3, OLED::Quarter::D};
-    chat.send(0, 3);
-    chat.send(GlyphPair::err.left);
-    chat.send(GlyphPair::err.right);
-    chat.send3dec(status.error);
-    chat.send(0, 3);
-    chat.send(Glyph::at);
-    chat.send3dec(status.location);
-    flashError(status);
+static void calibrate() {
+  using Tuner = OLED::TimingTuner<OLED_DEVICE, I2C::FastModeTiming>;
+  using SlowDevice = I2C::TunedDevice<OLED_DEVICE, I2C::FastModeTiming>;
+  uint8_t percents[Tuner::DELAYS];
+  bool const tuned = Tuner::tune(4, percents);
+  // The percentage of each delay, in the order of Tuner::Delay, three per quarter.
+  for (uint8_t line = 0; line < 2; ++line) {
+    auto const quarter = line == 0 ? OLED::Quarter::B : OLED::Quarter::C;
+    for (uint8_t pass = 0; pass < OLED::QuarterChat<SlowDevice>::PASSES; ++pass) {
+      auto chat = GlyphsOnQuarter<SlowDevice> {2, quarter, 0, OLED::WIDTH - 1, false, pass};
+      chat.send(0, 3);
+      for (uint8_t d = line * 3; d < line * 3 + 3; ++d) {
+        if (tuned) {
+          chat.send3dec(percents[d]);
+        } else {
+          chat.send(GlyphPair::err.left);
+          chat.send(GlyphPair::err.right);
+        }
+        chat.send(0, 6);
+      }
+      flashError(chat.stop());
+    }
   }
+  for (;;) {}
 }
 
-static I2C::Status displayRoom() {
-  auto chat = OLED::Chat<OLED_DEVICE>(20).start_data();
-  for (uint8_t c = 0; c < COLS; c += 1) {
-    uint8_t buf[BYTES_PER_X * X_PER_COL];
-    for (uint8_t rp = 0; rp < ROWS / ROWS_PER_BYTE; rp += 1) {
-      uint8_t const r = rp * ROWS_PER_BYTE;
+// Show the cycles per pixel column spent composing the room, for each geometry
+// on its own line: columns and rows of pixels per cell, then cycles.
+static void benchmarkGeometries() {
+  uint16_t const cycles[] = {
+    composeCyclesPerColumn<CellGeometry<2, 2>>(),
+    composeCyclesPerColumn<CellGeometry<4, 4>>(),
+    composeCyclesPerColumn<CellGeometry<8, 8>>(),
+    composeCyclesPerColumn<CellGeometry<4, 8>>(),
+  };
+  static uint8_t constexpr sizes[][2] = { {2, 2}, {4, 4}, {8, 8}, {4, 8} };
+  for (uint8_t q = 0; q < 4; ++q) {
+    if (TELEMETRY) {
+      Telemetry::sendGeometry(sizes[q][0], sizes[q][1], cycles[q]);
+    }
+    for (uint8_t pass = 0; pass < OLED::QuarterChat<OLED_DEVICE>::PASSES; ++pass) {
+      auto chat = GlyphsOnQuarter<OLED_DEVICE> {90, static_cast<OLED::Quarter>(q), 0, OLED::WIDTH - 1, false, pass};
+      chat.send(Glyph::dec_digit[sizes[q][0]], Glyph::DIGIT_MARGIN);
+      chat.send(Glyph::X, Glyph::DIGIT_MARGIN);
+      chat.send(Glyph::dec_digit[sizes[q][1]], Glyph::DIGIT_MARGIN);
+      chat.send(0, 3);
+      chat.send4dec(cycles[q]);
+      flashError(chat.stop());
+    }
+  }
+  for (;;) {}
+}
 
-      uint8_t* const subbuf = &buf[rp];
-      for (uint8_t i = 0; i < X_PER_COL; ++i) {
-        subbuf[i * BYTES_PER_X] = 0;
+// Look up every cell of the room a number of times, and return the tenths of
+// cycles taken per lookup, including the loop around it.
+template <typename Lookup>
+static uint16_t lookupTenthCycles(Lookup lookup) {
+  static uint8_t constexpr PASSES = 8;
+  uint8_t volatile sink;
+  unsigned long const start = micros();
+  for (uint8_t pass = 0; pass < PASSES; ++pass) {
+    for (uint8_t row = 0; row < ROWS; ++row) {
+      for (uint8_t col = 0; col < COLS; ++col) {
+        sink = lookup(row, col);
       }
+    }
+  }
+  (void)sink;
+  unsigned long const us = micros() - start;
+  return us * (F_CPU / 100000) / (PASSES * uint16_t(ROWS * COLS));
+}
 
-      // room
-      for (uint8_t s = 0; s < ROWS_PER_BYTE; ++s) {
-        if (getWall(r + s, c)) {
-          for (uint8_t i = 0; i < X_PER_COL; ++i) {
-            subbuf[i * BYTES_PER_X] |= 0xF << (s * Y_PER_ROW);
-          }
-        }
-      }
+static void benchmarkWalls() {
+  uint16_t const tenths[] = {
+    lookupTenthCycles([](uint8_t row, uint8_t col) { return getWall(row, col); }),
+    lookupTenthCycles([](uint8_t row, uint8_t col) { return uint8_t(walls(row, col)); }),
+    lookupTenthCycles([](uint8_t row, uint8_t col) { return uint8_t(row ^ col); }),
+  };
+  if (TELEMETRY) {
+    Telemetry::sendWalls(tenths[0], tenths[1], tenths[2]);
+  }
+  for (uint8_t q = 0; q < 3; ++q) {
+    for (uint8_t pass = 0; pass < OLED::QuarterChat<OLED_DEVICE>::PASSES; ++pass) {
+      auto chat = GlyphsOnQuarter<OLED_DEVICE> {90, static_cast<OLED::Quarter>(q), 0, OLED::WIDTH - 1, false, pass};
+      chat.send(0, 3);
+      chat.send3dec(tenths[q] / 10);
+      chat.sendPoint();
+      chat.send(Glyph::dec_digit[tenths[q] % 10], Glyph::DIGIT_MARGIN);
+      flashError(chat.stop());
+    }
+  }
+  for (;;) {}
+}
 
-      // ball
-      int8_t const ballXoffset = int8_t(ballX) - int8_t(c * X_PER_COL);
-      int8_t const ballYoffset = int8_t(ballY) - int8_t(r * Y_PER_ROW);
-      if (ballXoffset < X_PER_COL && -Y_PER_ROW < ballYoffset && ballYoffset < Y_PER_ROW * 2) {
-        uint8_t const i0 =         0 + (ballXoffset < 0 ? -ballXoffset : 0);
-        uint8_t const iN = X_PER_COL - (ballXoffset < 0 ? 0 : ballXoffset);
-        for (uint8_t i = i0; i < iN; ++i) {
-          subbuf[(i + ballXoffset) * BYTES_PER_X] |= leftshift(ball_shape[i], ballYoffset);
-        }
+static uint8_t const scene_ball[] PROGMEM = { 0x3C, 0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0x7E, 0x3C };
+
+// Show a room-like scene drawn by primitives rather than cells.
+static I2C::Status showScene() {
+  static Glyph const* const digits[] = {
+    &Glyph::dec_digit[X_PER_COL], &Glyph::X, &Glyph::dec_digit[Y_PER_ROW],
+  };
+  DisplayList<12> scene;
+  scene.rect(0, 0, OLED::WIDTH - 1, 3)
+  .rect(0, OLED::HEIGHT - 4, OLED::WIDTH - 1, OLED::HEIGHT - 1)
+  .rect(0, 4, 3, OLED::HEIGHT - 5)
+  .rect(OLED::WIDTH - 4, 4, OLED::WIDTH - 1, OLED::HEIGHT - 5)
+  .line(4, 4, 60, 59)
+  .line(123, 4, 67, 59)
+  .line(4, 31, 123, 31)
+  .bitmap(40, 12, sizeof scene_ball, 1, scene_ball)
+  .glyphs(80, 40, digits, 3);
+  I2C::traffic() = I2C::Traffic {};
+  auto const err = scene.display<OLED_DEVICE>(100);
+  if (TELEMETRY) {
+    Telemetry::sendScene(scene.size(), I2C::traffic().bytes, scene.rasterCyclesPerColumn());
+  }
+  return err;
+}
+
+// Compose the overlays of the given priority into what's composed so far.
+static void composeOverlays(Overlay::Priority priority, uint8_t c, uint8_t rp, uint8_t* out, uint8_t stride) {
+  for (Overlay* overlay : overlays) {
+    if (overlay && overlay->priority() == priority) {
+      for (uint8_t i = 0; i < X_PER_COL; ++i) {
+        out[i * stride] = overlay->compose(rp, c * X_PER_COL + i, out[i * stride]);
       }
     }
-    for (uint8_t i = 0; i < sizeof buf; ++i) {
-      chat.send(buf[i]);
+  }
+}
+
+// Compose the display bytes of page rp of the pixel columns in cell column c,
+// storing them stride bytes apart.
+static void composeCells(uint8_t c, uint8_t rp, uint8_t* out, uint8_t stride) {
+  using Kernel = CellKernel<Cells>;
+  Kernel::walls(out, stride, Kernel::wallRows(walls, c, rp));
+  composeOverlays(Overlay::UNDER_BALL, c, rp, out, stride);
+  Kernel::ball(out, stride, int8_t(ball.x) - int8_t(c * X_PER_COL), int8_t(ball.y) - int8_t(rp * 8));
+  composeOverlays(Overlay::OVER_BALL, c, rp, out, stride);
+}
+
+// Composing the room for RoomFlush.
+struct ComposeRoom {
+  static void cells(uint8_t c, uint8_t rp, uint8_t* out, uint8_t stride) {
+    composeCells(c, rp, out, stride);
+  }
+};
+
+using Flush = RoomFlush<OLED_DEVICE, ComposeRoom>;
+
+static I2C::Status initDisplay() {
+  return Flush::prepare(OLED::Chat<OLED_DEVICE>(0).init())
+         .set_enabled()
+         .stop();
+}
+
+// Send the room from the given step onwards, advancing it past each step acknowledged.
+static I2C::Status displayRoom(uint8_t& step) {
+  return Flush::display(step);
+}
+
+static uint8_t constexpr RECOVERY_ATTEMPTS = 3;
+
+// How the bus has been holding up.
+static struct {
+  uint16_t frames;
+  uint16_t errors;
+  uint16_t recoveries;
+  uint16_t worst_recovery_us;
+} bus_stats;
+
+// Clear the bus after an error and send the rest of the interrupted frame.
+// If that fails too, the panel is also reinitialized on further attempts.
+static I2C::Status recoverRoom(uint8_t& step, I2C::Status err) {
+  unsigned long const start = micros();
+  for (uint8_t attempt = 0; err.error && attempt < RECOVERY_ATTEMPTS; ++attempt) {
+    ++bus_stats.errors;
+    Recorder::recordFault(err, ball.y, ball.x, ball.yDir, ball.xDir);
+    if (TELEMETRY) {
+      Telemetry::sendStatus(err);
+    }
+    err = I2C::clear_bus<OLED_DEVICE>(30 + attempt);
+    if (!err.error && attempt > 0) {
+      err = initDisplay();
+    }
+    if (!err.error && step < Flush::STEPS) {
+      err = displayRoom(step);
+    }
+  }
+  if (!err.error) {
+    ++bus_stats.recoveries;
+    unsigned long const took = micros() - start;
+    if (took > bus_stats.worst_recovery_us) {
+      bus_stats.worst_recovery_us = took > 0xFFFF ? 0xFFFF : took;
     }
   }
-  return chat.stop();
+  if (TELEMETRY) {
+    Telemetry::sendBus(bus_stats.errors, bus_stats.recoveries, bus_stats.worst_recovery_us);
+  }
+  return err;
 }
 
-static void move() {
-  for (uint8_t twice = 0; twice < 2; ++twice) {
-    // We consider the ball to be a square for collision detection.
-    // When moving in a positive direction, add the size of the ball
-    // because that's the edge of the square possibly hitting a wall.
-    uint8_t const edgeY = ballY + ballYDir + (ballYDir < 0 ? 0 : Y_PER_ROW - 1);
-    uint8_t const edgeX = ballX + ballXDir + (ballXDir < 0 ? 0 : X_PER_COL - 1);
-    bool const yHit = getWall(edgeY / Y_PER_ROW, ballX / X_PER_COL) != 0;
-    bool const xHit = getWall(ballY / Y_PER_ROW, edgeX / X_PER_COL) != 0;
-    if (yHit) {
-      ballYDir = -ballYDir;
+static I2C::Status showRoom() {
+  ++bus_stats.frames;
+  for (Overlay* overlay : overlays) {
+    // The status heartbeat beats with its own region instead.
+    if (overlay && overlay != &status) {
+      overlay->next_frame();
     }
-    if (xHit) {
-      ballXDir = -ballXDir;
+  }
+  walls.forget_changes(); // the whole room covers them
+  uint8_t step = 0;
+  auto err = displayRoom(step);
+  if (err.error) {
+    err = recoverRoom(step, err);
+  }
+  if (!err.error) {
+    for (uint8_t r = 0; r < regions.size(); ++r) {
+      regions.flushed(r, millis());
     }
-    if (!yHit && !xHit) {
-      ballY += ballYDir;
-      ballX += ballXDir;
-      return;
+  }
+  return err;
+}
+
+// Define the regions: the cells around the ball as often as possible, the
+// heartbeat and the status twice and once per second, and the whole room
+// every now and then, in case anything else got lost.
+static void addRegions() {
+  ball_region = regions.add(0, X_PER_COL - 1, 0, 0, 0, 0);
+  heartbeat_region = regions.add(X_PER_COL, 2 * X_PER_COL - 1, 0, 1, 500, 1);
+  status_region = regions.add(X_PER_COL, 10 * X_PER_COL - 1, 0, 1, 1000, 2);
+  regions.add(0, OLED::WIDTH - 1, 0, OLED::BYTES_PER_SEG - 1, 10000, 3);
+  overlays[0] = &status;
+}
+
+// Where the ball was last shown.
+static Ball shown_ball;
+
+// Show the frames per second since the status was last sent, now that it's being sent.
+static void updateStatus(unsigned long now_ms) {
+  static unsigned long status_ms = 0;
+  static uint16_t status_frame = 0;
+  uint16_t const fps = (bus_stats.frames - status_frame) * 1000UL / (now_ms - status_ms + 1);
+  status.clear();
+  status.put(3).put3dec(fps > 255 ? 255 : fps);
+  status_ms = now_ms;
+  status_frame = bus_stats.frames;
+}
+
+// Refresh the regions that are due, which always includes the cells covering
+// the ball where it was last shown and where it is now, and any cell whose
+// wall was knocked down, each in its own window of a cell.
+static I2C::Status refreshRegions() {
+  ++bus_stats.frames;
+  unsigned long const now_ms = millis();
+  uint8_t const xMin = shown_ball.x < ball.x ? shown_ball.x : ball.x;
+  uint8_t const xMax = (shown_ball.x < ball.x ? ball.x : shown_ball.x) + X_PER_COL - 1;
+  uint8_t const yMin = shown_ball.y < ball.y ? shown_ball.y : ball.y;
+  uint8_t const yMax = (shown_ball.y < ball.y ? ball.y : shown_ball.y) + Y_PER_ROW - 1;
+  regions.move(ball_region, xMin / X_PER_COL * X_PER_COL, xMax / X_PER_COL * X_PER_COL + X_PER_COL - 1, yMin / 8, yMax / 8);
+
+  OLED::Session<OLED_DEVICE> session(20);
+  Cell cell;
+  while (walls.changed(cell)) {
+    uint8_t const x = cell.col * X_PER_COL;
+    uint8_t const page = cell.row / ROWS_PER_BYTE;
+    Flush::region(session, x, x + X_PER_COL - 1, page, page);
+  }
+  regions.run(now_ms, BUS_BYTES_PER_FRAME, [&](RegionScheduler<4>::Region const & r) {
+    if (&r == &regions[heartbeat_region]) {
+      status.next_frame();
+    }
+    if (&r == &regions[status_region]) {
+      updateStatus(now_ms);
+    }
+    return Flush::region(session, r.xBegin, r.xEnd, r.pageBegin, r.pageEnd);
+  });
+  auto err = session.stop();
+  if (err.error) {
+    uint8_t step = 0;
+    err = recoverRoom(step, err);
+  }
+  shown_ball = ball;
+  return err;
+}
+
+// Report how the next region has been keeping up with its rate.
+static void reportRegion() {
+  static uint8_t next = 0;
+  regions.report(next, millis(), [](uint16_t period_ms, uint16_t refreshes, uint16_t elapsed_ms, uint8_t most_skipped) {
+    Telemetry::sendRegion(next, most_skipped, period_ms, refreshes, elapsed_ms);
+  });
+  next = (next + 1) % regions.size();
+}
+
+// Report an error while we think we can display it.
+static void displayError(I2C::Status status) {
+  if (status.error) {
+    // Peak stack depth and RAM never used, in case we ran out of it.
+    Overlay memory { OLED::Quarter::C };
+    memory.put(3).put4dec(Memory::peakStackBytes()).put(3).put4dec(Memory::unusedBytes());
+    Overlay error { OLED::Quarter::D, 0, Overlay::OVER_BALL, true, true };
+    error.put(3).put(GlyphPair::err).put3dec(status.error).put(3).put(Glyph::at).put3dec(status.location);
+    overlays[0] = &memory;
+    overlays[1] = &error;
+    showRoom();
+    flashError(status);
+  }
+}
+
+// Show what the flight recorder holds, most recent first, four records at a time.
+static void dumpRecorder() {
+  for (;;) {
+    for (uint8_t age = 0; age < Recorder::SLOTS; age += 4) {
+      for (uint8_t q = 0; q < 4; ++q) {
+        auto const quarter = static_cast<OLED::Quarter>(q);
+        auto const r = Recorder::read(age + q);
+        for (uint8_t pass = 0; pass < OLED::QuarterChat<OLED_DEVICE>::PASSES; ++pass) {
+          GlyphsOnQuarter<OLED_DEVICE> {70, quarter, 0, OLED::WIDTH - 1, false, pass}
+          .send(0, OLED::WIDTH)
+          .stop();
+          auto chat = GlyphsOnQuarter<OLED_DEVICE> {80, quarter, 0, OLED::WIDTH - 1, false, pass};
+          if (r.kind == Recorder::FAULT) {
+            chat.send3dec(r.seq);
+            chat.send(GlyphPair::err.left);
+            chat.send(GlyphPair::err.right);
+            chat.send3dec(r.payload[0]);
+            chat.send(Glyph::at);
+            chat.send3dec(r.payload[1]);
+          } else if (r.kind == Recorder::RATE) {
+            uint16_t const ms_per_frame = r.payload[2] | r.payload[3] << 8;
+            uint16_t const bus_errors = r.payload[4] | r.payload[5] << 8;
+            chat.send3dec(r.seq);
+            chat.send4dec(ms_per_frame);
+            chat.sendColon();
+            chat.send4dec(bus_errors);
+          }
+          flashError(chat.stop());
+        }
+      }
+      delay(3000);
     }
   }
-  displayError(I2C::Status { 11, 0 }); // trapped between walls
 }
 
 void setup() {
   pinMode(LED_BUILTIN, OUTPUT);
   digitalWrite(LED_BUILTIN, HIGH);
   USI_TWI_Master_Initialise();
-  auto err = OLED::Chat<OLED_DEVICE>(0)
-             .init()
-             .set_addressing_mode(OLED::VerticalAddressing)
-             .set_column_address()
-             .set_page_address()
-             .set_enabled()
-             .stop();
+  Recorder::begin();
+  walls.reset();
+  if (TELEMETRY) {
+    Telemetry::begin();
+  }
+  auto err = initDisplay();
+  if (CALIBRATE_I2C && !err.error) {
+    calibrate();
+  }
+  if (DUMP_RECORDER && !err.error) {
+    dumpRecorder();
+  }
+  if (BENCHMARK_GEOMETRIES && !err.error) {
+    benchmarkGeometries();
+  }
+  if (BENCHMARK_WALLS && !err.error) {
+    benchmarkWalls();
+  }
+  if (SHOW_SPLASH && !err.error) {
+    I2C::traffic() = I2C::Traffic {};
+    err = Animation::play<OLED_DEVICE>(splash, SPLASH_FRAMES, 150);
+    if (TELEMETRY) {
+      Telemetry::sendAnimation(sizeof splash, I2C::traffic().bytes,
+                               Animation::decodeCyclesPerByte(splash, SPLASH_FRAMES));
+    }
+  }
+  if (SHOW_SCENE && !err.error) {
+    err = showScene();
+    delay(3000);
+  }
+  if (REFRESH_REGIONS) {
+    addRegions();
+  }
   if (!err.error) {
-    err = displayRoom();
+    err = showRoom();
   }
+  shown_ball = ball;
   digitalWrite(LED_BUILTIN, LOW);
   flashError(err);
 }
 
 void loop() {
+  unsigned long const t0 = micros();
   digitalWrite(LED_BUILTIN, HIGH);
-  move();
+  bool const moved = move(ball, walls, DESTRUCTIBLE_WALLS);
   digitalWrite(LED_BUILTIN, LOW);
-  auto err = displayRoom();
+  if (!moved) {
+    displayError(I2C::Status { 11, 0 }); // trapped between walls
+  }
+  unsigned long const t1 = micros();
+  I2C::traffic() = I2C::Traffic {};
+  auto err = REFRESH_REGIONS ? refreshRegions() : showRoom();
+  if (TELEMETRY) {
+    unsigned long const t2 = micros();
+    Telemetry::sendFrame(bus_stats.frames, t1 - t0, t2 - t1, I2C::traffic());
+    if (err.error) {
+      Telemetry::sendStatus(err);
+    }
+    if (bus_stats.frames % 64 == 0) {
+      Telemetry::sendMemory(Memory::staticBytes(), Memory::peakStackBytes(), Memory::unusedBytes());
+    } else if (REFRESH_REGIONS && bus_stats.frames % 16 == 0) {
+      reportRegion();
+    }
+  }
   displayError(err);
+
+  static unsigned long sample_start_ms = 0;
+  static uint16_t sample_start_frame = 0;
+  unsigned long const now_ms = millis();
+  if (now_ms - sample_start_ms >= RATE_SAMPLE_MS) {
+    uint16_t const frames = bus_stats.frames - sample_start_frame;
+    Recorder::recordRate(frames, (now_ms - sample_start_ms) / frames, bus_stats.errors);
+    sample_start_ms = now_ms;
+    sample_start_frame = bus_stats.frames;
+  }
+  Recorder::service();
 }
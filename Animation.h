@@ -0,0 +1,94 @@
+#pragma once
+#include "OLED.h"
+
+// Playing animations encoded by host/encode_animation.py, streaming straight
+// from PROGMEM to the display, without a frame buffer.
+namespace Animation {
+
+static uint8_t constexpr END_OF_FRAME = 0xFF;
+
+// Decode run-length coded bytes to out, until count bytes have been produced.
+template <typename Out>
+uint8_t const* decodeRuns(uint8_t const* p, uint16_t count, Out& out) {
+  while (count > 0) {
+    uint8_t const token = pgm_read_byte(p++);
+    uint8_t const n = (token & 0x7F) + 1;
+    if (token & 0x80) {
+      out.sendN(n, pgm_read_byte(p++));
+    } else {
+      for (uint8_t i = 0; i < n; ++i) {
+        out.send(pgm_read_byte(p++));
+      }
+    }
+    count -= n;
+  }
+  return p;
+}
+
+// Display the frame at p, which is advanced to the next frame.
+// All spans of a frame go in a single transaction.
+template <typename Device>
+I2C::Status playFrame(uint8_t const*& p) {
+  OLED::Session<Device> session(50);
+  for (;;) {
+    uint8_t const xBegin = pgm_read_byte(p++);
+    if (xBegin == END_OF_FRAME) {
+      return session.stop();
+    }
+    uint8_t const xEnd = pgm_read_byte(p++);
+    auto& data = session.window(xBegin, xEnd);
+    p = decodeRuns(p, (xEnd - xBegin + 1) * OLED::BYTES_PER_SEG, data);
+  }
+}
+
+// Display all frames, pausing between them. The window is left as the last
+// span had it, for whatever is displayed next sets its own.
+template <typename Device>
+I2C::Status play(uint8_t const* p, uint8_t frames, unsigned long ms_per_frame) {
+  for (uint8_t f = 0; f < frames; ++f) {
+    auto const err = playFrame<Device>(p);
+    if (err.error) {
+      return err;
+    }
+    delay(ms_per_frame);
+  }
+  return I2C::Status { 0, 0 };
+}
+
+
+// Stand-in for a chat, merely counting what it's told to send.
+struct Counter {
+  uint16_t bytes;
+  uint8_t volatile last; // keeps the compiler from skipping the decoding
+
+  void send(uint8_t b) {
+    ++bytes;
+    last = b;
+  }
+
+  void sendN(uint8_t n, uint8_t b) {
+    bytes += n;
+    last = b;
+  }
+};
+
+// Measure the cost of decoding the animation apart from the bus,
+// in cycles per displayed byte.
+static uint16_t decodeCyclesPerByte(uint8_t const* p, uint8_t frames) {
+  Counter counter {};
+  unsigned long const start = micros();
+  for (uint8_t f = 0; f < frames; ++f) {
+    for (;;) {
+      uint8_t const xBegin = pgm_read_byte(p++);
+      if (xBegin == END_OF_FRAME) {
+        break;
+      }
+      uint8_t const xEnd = pgm_read_byte(p++);
+      p = decodeRuns(p, (xEnd - xBegin + 1) * OLED::BYTES_PER_SEG, counter);
+    }
+  }
+  unsigned long const us = micros() - start;
+  return us * (F_CPU / 1000000) / counter.bytes;
+}
+
+}
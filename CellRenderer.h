@@ -0,0 +1,118 @@
+#pragma once
+#include <Arduino.h>
+#include "Room.h"
+
+// Composing the display bytes of the room, for any geometry of cells that fits
+// in whole numbers of pixels and pages. Everything depending on the geometry is
+// a compile time constant, and loops over the pixel columns of a cell and the
+// rows within a page are unrolled, so that no geometry takes a generic slow path.
+template <uint8_t X_PER_COL_, uint8_t Y_PER_ROW_>
+struct CellGeometry {
+  static uint8_t constexpr X_PER_COL = X_PER_COL_;
+  static uint8_t constexpr Y_PER_ROW = Y_PER_ROW_;
+  static uint8_t constexpr COLS = 128 / X_PER_COL;
+  static uint8_t constexpr ROWS = 64 / Y_PER_ROW;
+  static uint8_t constexpr ROWS_PER_BYTE = 8 / Y_PER_ROW;
+  static uint8_t constexpr ROW_PIXELS = uint8_t((1u << Y_PER_ROW) - 1);
+  static_assert(8 % Y_PER_ROW == 0 && 128 % X_PER_COL == 0, "cells must tile the display");
+
+  // Pixels of the ball, as big as a cell, in pixel column i, with corners rounded off if it's big enough.
+  static constexpr uint8_t ballColumn(uint8_t i) {
+    return X_PER_COL >= 4 && Y_PER_ROW >= 4 && (i == 0 || i == X_PER_COL - 1)
+           ? ROW_PIXELS & ~(1 | 1 << (Y_PER_ROW - 1))
+           : ROW_PIXELS;
+  }
+};
+
+// Calls f(0), f(1), … f(N - 1), without a loop.
+template <uint8_t N>
+struct Unrolled {
+  template <typename F>
+  __attribute__((always_inline)) static void each(F const& f) {
+    Unrolled<N - 1>::each(f);
+    f(N - 1);
+  }
+};
+
+template <>
+struct Unrolled<0> {
+  template <typename F>
+  __attribute__((always_inline)) static void each(F const&) {}
+};
+
+template <typename Geometry>
+struct CellKernel {
+  using G = Geometry;
+
+  static uint8_t leftshift(uint8_t value, int8_t positions) {
+    return positions >= 0 ? (value << positions) : (value >> -positions);
+  }
+
+  // Rows in page rp of cell column c having a wall, as bit s for row rp * ROWS_PER_BYTE + s.
+  template <typename Walls>
+  __attribute__((always_inline)) static uint8_t wallRows(Walls const& walls, uint8_t c, uint8_t rp) {
+    uint8_t rows = 0;
+    Unrolled<G::ROWS_PER_BYTE>::each([&](uint8_t s) __attribute__((always_inline)) {
+      if (walls(rp * G::ROWS_PER_BYTE + s, c)) {
+        rows |= 1 << s;
+      }
+    });
+    return rows;
+  }
+
+  // Set the X_PER_COL bytes, stride apart, to the walls in the given rows.
+  __attribute__((always_inline)) static void walls(uint8_t* out, uint8_t stride, uint8_t rows) {
+    uint8_t pattern = 0;
+    Unrolled<G::ROWS_PER_BYTE>::each([&](uint8_t s) __attribute__((always_inline)) {
+      if (rows >> s & 1) {
+        pattern |= G::ROW_PIXELS << (s * G::Y_PER_ROW);
+      }
+    });
+    Unrolled<G::X_PER_COL>::each([&](uint8_t i) __attribute__((always_inline)) {
+      out[i * stride] = pattern;
+    });
+  }
+
+  // Add the ball to the X_PER_COL bytes, stride apart, given its position
+  // relative to the leftmost pixel column and top pixel row they cover.
+  __attribute__((always_inline)) static void ball(uint8_t* out, uint8_t stride, int8_t xOffset, int8_t yOffset) {
+    if (-int8_t(G::X_PER_COL) < xOffset && xOffset < int8_t(G::X_PER_COL)
+        && -int8_t(G::Y_PER_ROW) < yOffset && yOffset < 8) {
+      Unrolled<G::X_PER_COL>::each([&](uint8_t i) __attribute__((always_inline)) {
+        int8_t const x = xOffset + int8_t(i);
+        if (0 <= x && x < int8_t(G::X_PER_COL)) {
+          out[x * stride] |= leftshift(G::ballColumn(i), yOffset);
+        }
+      });
+    }
+  }
+};
+
+// Measures the compose kernel of Geometry on a version of the room scaled
+// to it, in cycles per pixel column, without any bus traffic.
+template <typename Geometry>
+uint16_t composeCyclesPerColumn() {
+  using K = CellKernel<Geometry>;
+  using G = Geometry;
+  auto const scaledWall = [](uint8_t row, uint8_t col) {
+    return getWall(row * G::Y_PER_ROW / Y_PER_ROW, col * G::X_PER_COL / X_PER_COL) != 0;
+  };
+  static uint8_t constexpr FRAMES = 4;
+  uint8_t volatile sink;
+  uint8_t buf[G::X_PER_COL * 8];
+  unsigned long const start = micros();
+  for (uint8_t f = 0; f < FRAMES; ++f) {
+    uint8_t const ballX = 5 * G::X_PER_COL + f;
+    uint8_t const ballY = 3 * G::Y_PER_ROW + f;
+    for (uint8_t c = 0; c < G::COLS; ++c) {
+      for (uint8_t rp = 0; rp < 8; ++rp) {
+        K::walls(&buf[rp], 8, K::wallRows(scaledWall, c, rp));
+        K::ball(&buf[rp], 8, int8_t(ballX - c * G::X_PER_COL), int8_t(ballY - rp * 8));
+      }
+      sink = buf[c % sizeof buf];
+    }
+  }
+  (void)sink;
+  unsigned long const us = micros() - start;
+  return us * (F_CPU / 1000000) / (FRAMES * 128u);
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include "Glyph.h"
+#include "OLED.h"
+
+// A scene described by a short list of primitives, rasterized one pixel column
+// at a time while it is being sent, so that no frame buffer is needed.
+// Primitives are kept sorted by their first column. While rasterizing, those
+// that started and didn't end yet form the active list, so that each column
+// only looks at the primitives overlapping it. Each primitive costs a bounded
+// number of cycles per column: the worst column costs CAPACITY of those, never
+// a scan of the whole scene or a division. All primitives set pixels, so the
+// order in which they overlap doesn't matter.
+template <uint8_t CAPACITY>
+class DisplayList {
+  private:
+    enum Kind : uint8_t {
+      RECT,
+      LINE,
+      BITMAP,
+      GLYPHS,
+    };
+
+    struct Primitive {
+      uint8_t kind;
+      uint8_t xBegin;
+      uint8_t xEnd; // last column covered
+      uint8_t y;    // top pixel row, or where a line starts
+      union {
+        struct {
+          uint8_t yEnd; // bottom pixel row
+        } rect;
+        struct {
+          int16_t slope;  // pixel rows per column, in 1/256th
+          int16_t yFixed; // pixel row in the current column, in 1/256th
+        } line;
+        struct {
+          uint8_t const* begin; // PROGMEM, pages bytes per column
+          uint8_t const* next;  // bytes of the current column
+          uint8_t pages;
+        } bitmap;
+        struct {
+          Glyph const* const* glyphs; // kept by the caller
+          uint8_t index;              // glyph in the current column
+          uint8_t offset;             // column within DIGIT_WIDTH
+        } glyphs;
+      };
+    };
+
+    Primitive items[CAPACITY];
+    uint8_t active[CAPACITY];
+    uint8_t length = 0;
+    uint8_t activeLength;
+    uint8_t nextItem;
+
+    Primitive* insert(Kind kind, uint8_t xBegin, uint8_t xEnd, uint8_t y) {
+      if (length == CAPACITY || xBegin > xEnd || xEnd >= OLED::WIDTH) {
+        return nullptr;
+      }
+      uint8_t i = length++;
+      for (; i > 0 && items[i - 1].xBegin > xBegin; --i) {
+        items[i] = items[i - 1];
+      }
+      Primitive& item = items[i];
+      item.kind = kind;
+      item.xBegin = xBegin;
+      item.xEnd = xEnd;
+      item.y = y;
+      return &item;
+    }
+
+    // Set pixel rows yBegin to yEnd, given yBegin <= yEnd.
+    static void span(uint8_t* col, uint8_t yBegin, uint8_t yEnd) {
+      if (yBegin >= OLED::HEIGHT) {
+        return;
+      }
+      if (yEnd >= OLED::HEIGHT) {
+        yEnd = OLED::HEIGHT - 1;
+      }
+      uint8_t const pBegin = yBegin / 8;
+      uint8_t const pEnd = yEnd / 8;
+      for (uint8_t p = pBegin; p <= pEnd; ++p) {
+        uint8_t mask = 0xFF;
+        if (p == pBegin) {
+          mask &= 0xFF << (yBegin % 8);
+        }
+        if (p == pEnd) {
+          mask &= 0xFF >> (7 - yEnd % 8);
+        }
+        col[p] |= mask;
+      }
+    }
+
+    // Set the pixels of byte b, whose lowest bit is pixel row y.
+    static void place(uint8_t* col, uint8_t y, uint8_t b) {
+      uint8_t const p = y / 8;
+      uint8_t const shift = y % 8;
+      if (p < OLED::BYTES_PER_SEG) {
+        col[p] |= b << shift;
+      }
+      if (shift && p + 1 < OLED::BYTES_PER_SEG) {
+        col[p + 1] |= b >> (8 - shift);
+      }
+    }
+
+    void activate(Primitive& item) {
+      switch (item.kind) {
+        case LINE:
+          item.line.yFixed = int16_t(item.y) * 256;
+
+          break;
+        case BITMAP:
+          item.bitmap.next = item.bitmap.begin;
+          break;
+        case GLYPHS:
+          item.glyphs.index = 0;
+          item.glyphs.offset = 0;
+          break;
+      }
+    }
+
+    // Add the pixels of item in column x to col, and advance to the next column.
+    static void rasterize(Primitive& item, uint8_t x, uint8_t* col) {
+      switch (item.kind) {
+        case RECT:
+          span(col, item.y, item.rect.yEnd);
+          break;
+        case LINE: {
+          uint8_t const yNow = uint8_t((item.line.yFixed + 0x80) >> 8);
+          item.line.yFixed += item.line.slope;
+          uint8_t const yNext = x == item.xEnd ? yNow : uint8_t((item.line.yFixed + 0x80) >> 8);
+          if (yNext > yNow) {
+            span(col, yNow, yNext - 1);
+          } else if (yNext < yNow) {
+            span(col, yNext + 1, yNow);
+          } else {
+            span(col, yNow, yNow);
+          }
+          break;
+        }
+        case BITMAP:
+          for (uint8_t p = 0; p < item.bitmap.pages; ++p) {
+            place(col, item.y + p * 8, pgm_read_byte(item.bitmap.next++));
+          }
+          break;
+        case GLYPHS: {
+          uint8_t const seg = item.glyphs.offset - Glyph::DIGIT_MARGIN;
+          if (seg < Glyph::SEGS) {
+            place(col, item.y, item.glyphs.glyphs[item.glyphs.index]->seg(seg));
+          }
+          if (++item.glyphs.offset == Glyph::DIGIT_WIDTH) {
+            item.glyphs.offset = 0;
+            ++item.glyphs.index;
+          }
+          break;
+        }
+      }
+    }
+
+  public:
+    // Fill pixel columns xBegin to xEnd and rows yBegin to yEnd.
+    DisplayList& rect(uint8_t xBegin, uint8_t yBegin, uint8_t xEnd, uint8_t yEnd) {
+      if (yBegin <= yEnd) {
+        if (Primitive* item = insert(RECT, xBegin, xEnd, yBegin)) {
+          item->rect.yEnd = yEnd;
+        }
+      }
+      return *this;
+    }
+
+    // Draw a line between two pixels, in either direction.
+    DisplayList& line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+      if (x0 > x1) {
+        return line(x1, y1, x0, y0);
+      }
+      if (x0 == x1) {
+        return y0 <= y1 ? rect(x0, y0, x1, y1) : rect(x0, y1, x1, y0);
+      }
+      if (Primitive* item = insert(LINE, x0, x1, y0)) {
+        item->line.slope = int16_t(y1 - y0) * 256 / int16_t(x1 - x0);
+
+      }
+      return *this;
+    }
+
+    // Draw a bitmap of width columns of pages bytes each, stored in PROGMEM
+    // column after column, with its top pixel row at y.
+    DisplayList& bitmap(uint8_t x, uint8_t y, uint8_t width, uint8_t pages, uint8_t const* bytes) {
+      if (width > 0) {
+        if (Primitive* item = insert(BITMAP, x, x + width - 1, y)) {
+          item->bitmap.begin = bytes;
+          item->bitmap.pages = pages;
+        }
+      }
+      return *this;
+    }
+
+    // Draw count glyphs, laid out like digits, with their top pixel row at y.
+    // The array of glyphs must outlive the display list.
+    DisplayList& glyphs(uint8_t x, uint8_t y, Glyph const* const* glyphs, uint8_t count) {
+      if (count > 0) {
+        if (Primitive* item = insert(GLYPHS, x, x + count * Glyph::DIGIT_WIDTH - 1, y)) {
+          item->glyphs.glyphs = glyphs;
+        }
+      }
+      return *this;
+    }
+
+    uint8_t size() const {
+      return length;
+    }
+
+    void rewind() {
+      activeLength = 0;
+      nextItem = 0;
+    }
+
+    // Compose the display bytes of pixel column x, given columns are asked for
+    // in increasing order after rewind().
+    void column(uint8_t x, uint8_t* col) {
+      for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+        col[p] = 0;
+      }
+      for (uint8_t a = 0; a < activeLength;) {
+        if (items[active[a]].xEnd < x) {
+          active[a] = active[--activeLength];
+        } else {
+          ++a;
+        }
+      }
+      for (; nextItem < length && items[nextItem].xBegin <= x; ++nextItem) {
+        if (items[nextItem].xEnd >= x) {
+          activate(items[nextItem]);
+          active[activeLength++] = nextItem;
+        }
+      }
+      for (uint8_t a = 0; a < activeLength; ++a) {
+        rasterize(items[active[a]], x, col);
+      }
+    }
+
+    // Display the whole scene. With windowing, that's one pass in vertical
+    // addressing order. Otherwise, each page takes a pass over all columns.
+    template <typename Device>
+    I2C::Status display(uint8_t start_location) {
+      OLED::Session<Device> session(start_location);
+      uint8_t col[OLED::BYTES_PER_SEG];
+      if (Device::Controller::WINDOWING) {
+        auto& data = session.window(0, OLED::WIDTH - 1);
+        rewind();
+        for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+          column(x, col);
+          for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+            data.send(col[p]);
+          }
+        }
+      } else {
+        for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+          auto& data = session.position(p, 0);
+          rewind();
+          for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+            column(x, col);
+            data.send(col[p]);
+          }
+        }
+      }
+      return session.stop();
+    }
+
+    // Measure the cost of rasterizing the scene apart from the bus,
+    // in cycles per pixel column.
+    uint16_t rasterCyclesPerColumn() {
+      uint8_t volatile sink;
+      uint8_t col[OLED::BYTES_PER_SEG];
+      unsigned long const start = micros();
+      rewind();
+      for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+        column(x, col);
+        sink = col[x % OLED::BYTES_PER_SEG];
+      }
+      (void)sink;
+      unsigned long const us = micros() - start;
+      return us * (F_CPU / 1000000) / OLED::WIDTH;
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include "I2C.h"
+#include "RecorderFormat.h"
+#include <avr/eeprom.h>
+#include <stddef.h>
+
+// Keeps the latest records of what happened in EEPROM, to survive a halt or reset.
+// Writing one EEPROM byte takes milliseconds, so records are queued in RAM and
+// written out a byte at a time, whenever the EEPROM is ready for the next one.
+namespace Recorder {
+
+static uint8_t constexpr QUEUE_SIZE = 2;
+static_assert(QUEUE_SIZE >= 2, "one record may be being written while another makes way");
+
+static Record queue[QUEUE_SIZE];
+static uint8_t queued;    // records in queue
+static uint8_t written;   // bytes of the first queued record already written
+static uint8_t head;      // slot to write the next record to
+static uint8_t next_seq;
+
+static uint8_t* slot(uint8_t index) {
+  return reinterpret_cast<uint8_t*>(index * sizeof(Record));
+}
+
+static uint8_t readKind(uint8_t index) {
+  return eeprom_read_byte(slot(index) + offsetof(Record, kind));
+}
+
+static uint8_t readSeq(uint8_t index) {
+  return eeprom_read_byte(slot(index) + offsetof(Record, seq));
+}
+
+// Find where the ring left off.
+static void begin() {
+  head = 0;
+  for (uint8_t i = 0; i < SLOTS; ++i) {
+    if (readKind(i) == ERASED || (i > 0 && readSeq(i) != uint8_t(readSeq(i - 1) + 1))) {
+      head = i;
+      break;
+    }
+  }
+  uint8_t const last = (head + SLOTS - 1) % SLOTS;
+  next_seq = readKind(last) == ERASED ? 0 : readSeq(last) + 1;
+}
+
+// Queue a record. If the queue is full, the oldest record not being written yet
+// makes way, since the latest record, such as the fault that halts everything,
+// tells most.
+static void record(Kind kind, uint8_t const* payload) {
+  if (queued == QUEUE_SIZE) {
+    uint8_t const oldest = written == 0 ? 0 : 1;
+    --queued;
+    for (uint8_t i = oldest; i < queued; ++i) {
+      queue[i] = queue[i + 1];
+    }
+  }
+  Record& r = queue[queued++];
+  r.kind = kind;
+  for (uint8_t i = 0; i < sizeof r.payload; ++i) {
+    r.payload[i] = payload[i];
+  }
+}
+
+static void recordFault(I2C::Status status, uint8_t ballY, uint8_t ballX, int8_t ballYDir, int8_t ballXDir) {
+  uint8_t const payload[] = { status.error, status.location, ballY, ballX, uint8_t(ballYDir), uint8_t(ballXDir) };
+  record(FAULT, payload);
+}
+
+static void recordRate(uint16_t frames, uint16_t ms_per_frame, uint16_t bus_errors) {
+  uint16_t const payload[] = { frames, ms_per_frame, bus_errors };
+  record(RATE, reinterpret_cast<uint8_t const*>(payload));
+}
+
+// Write the next byte, if any and if the EEPROM is ready for it. First the kind is
+// erased, then the rest of the record written, and finally the actual kind.
+// Returns whether there is more to write.
+static bool service() {
+  if (queued == 0) {
+    return false;
+  }
+  if (!eeprom_is_ready()) {
+    return true;
+  }
+  uint8_t* const base = slot(head);
+  Record& r = queue[0];
+  if (written == 0) {
+    // Numbered only now, so that records making way leave no gap in the sequence.
+    r.seq = next_seq++;
+    eeprom_update_byte(base + offsetof(Record, kind), ERASED);
+  } else if (written < sizeof(Record)) {
+    eeprom_update_byte(base + written, reinterpret_cast<uint8_t const*>(&r)[written]);
+  } else {
+    eeprom_update_byte(base + offsetof(Record, kind), r.kind);
+    head = (head + 1) % SLOTS;
+    written = 0;
+    --queued;
+    for (uint8_t i = 0; i < queued; ++i) {
+      queue[i] = queue[i + 1];
+    }
+    return queued != 0;
+  }
+  ++written;
+  return true;
+}
+
+// Write out everything queued, waiting as long as that takes.
+static void flush() {
+  while (service()) {
+  }
+}
+
+// Read the record that is age records older than the most recent one.
+static Record read(uint8_t age) {
+  Record r;
+  eeprom_read_block(&r, slot((head + SLOTS - 1 - age % SLOTS) % SLOTS), sizeof r);
+  return r;
+}
+
+}
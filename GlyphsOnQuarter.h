@@ -18,7 +18,9 @@ class GlyphsOnQuarter : public OLED::QuarterChat<Device> {
       if (include_heartbeat) {
         include_heartbeat = false;
         static uint8_t heartbeat_per_quarter = 0b0000;
-        heartbeat_per_quarter ^= quarter_bit;
+        if (super::pass == 0) {
+          heartbeat_per_quarter ^= quarter_bit;
+        }
         return heartbeat_per_quarter & quarter_bit;
       } else {
         return false;
@@ -29,8 +31,8 @@ class GlyphsOnQuarter : public OLED::QuarterChat<Device> {
     // start_location is merely the initial value of a counter for error reporting.
     explicit GlyphsOnQuarter(uint8_t start_location,
                              OLED::Quarter quarter, uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1,
-                             bool include_heartbeat = true)
-      : super(start_location, quarter, xBegin, xEnd)
+                             bool include_heartbeat = true, uint8_t pass = 0)
+      : super(start_location, quarter, xBegin, xEnd, pass)
       , quarter_bit(uint8_t(1 << static_cast<uint8_t>(quarter)))
       , include_heartbeat(include_heartbeat) {
     }
@@ -11,6 +11,66 @@ struct Status {
   uint8_t location;
 };
 
+// Running count of what went over the bus, for measuring purposes only.
+struct Traffic {
+  uint16_t transactions; // each from start to stop
+  uint16_t restarts;     // repeated starts, each saving a stop and a new start
+  uint16_t bytes;        // including address bytes
+};
+
+inline Traffic& traffic() {
+  static Traffic counters;
+  return counters;
+}
+
+// Free the bus after a failed conversation, so that a new one may start.
+template <typename Device>
+Status clear_bus(uint8_t location) {
+  return Status { USI_TWI_Master_Bus_Clear<Device>(), location };
+}
+
+// Minimum timing required by the I2C specification in fast mode (400 kHz),
+// expressed as the delays of the Device concept.
+struct FastModeTiming {
+  static constexpr USI_TWI_Delay tHSTART { 0.6 };        // tHD;STA
+  static constexpr USI_TWI_Delay tSSTOP { 0.6 };         // tSU;STO
+  static constexpr USI_TWI_Delay tIDLE { 1.3 };          // tBUF
+  static constexpr USI_TWI_Delay tPRE_SCL_HIGH { 1.3 };  // tLOW
+  static constexpr USI_TWI_Delay tPOST_SCL_HIGH { 0.6 }; // tHIGH
+  static constexpr USI_TWI_Delay tPOST_TRANSFER { 0 };
+};
+
+// Device Panel, with each delay of Timing cut down to a percentage of its own.
+template <typename Panel, typename Timing,
+          uint8_t HSTART = 100, uint8_t SSTOP = 100, uint8_t IDLE = 100,
+          uint8_t PRE_SCL_HIGH = 100, uint8_t POST_SCL_HIGH = 100, uint8_t POST_TRANSFER = 100>
+struct TunedDevice : Panel {
+  static constexpr USI_TWI_Delay tHSTART { Timing::tHSTART.scaled(HSTART) };
+  static constexpr USI_TWI_Delay tSSTOP { Timing::tSSTOP.scaled(SSTOP) };
+  static constexpr USI_TWI_Delay tIDLE { Timing::tIDLE.scaled(IDLE) };
+  static constexpr USI_TWI_Delay tPRE_SCL_HIGH { Timing::tPRE_SCL_HIGH.scaled(PRE_SCL_HIGH) };
+  static constexpr USI_TWI_Delay tPOST_SCL_HIGH { Timing::tPOST_SCL_HIGH.scaled(POST_SCL_HIGH) };
+  static constexpr USI_TWI_Delay tPOST_TRANSFER { Timing::tPOST_TRANSFER.scaled(POST_TRANSFER) };
+};
+
+// Device Panel, with delays set while running, one at a time, by a tuner.
+template <typename Panel>
+struct TunableDevice : Panel {
+  static USI_TWI_Variable_Delay tHSTART;
+  static USI_TWI_Variable_Delay tSSTOP;
+  static USI_TWI_Variable_Delay tIDLE;
+  static USI_TWI_Variable_Delay tPRE_SCL_HIGH;
+  static USI_TWI_Variable_Delay tPOST_SCL_HIGH;
+  static USI_TWI_Variable_Delay tPOST_TRANSFER;
+};
+
+template <typename Panel> USI_TWI_Variable_Delay TunableDevice<Panel>::tHSTART;
+template <typename Panel> USI_TWI_Variable_Delay TunableDevice<Panel>::tSSTOP;
+template <typename Panel> USI_TWI_Variable_Delay TunableDevice<Panel>::tIDLE;
+template <typename Panel> USI_TWI_Variable_Delay TunableDevice<Panel>::tPRE_SCL_HIGH;
+template <typename Panel> USI_TWI_Variable_Delay TunableDevice<Panel>::tPOST_SCL_HIGH;
+template <typename Panel> USI_TWI_Variable_Delay TunableDevice<Panel>::tPOST_TRANSFER;
+
 // Data conversation with an I2C device.
 template <typename Device>
 class Chat {
@@ -23,6 +83,8 @@ class Chat {
     explicit Chat(uint8_t start_location) :
       err{USI_TWI_Master_Start_Sending<Device>()},
       location{start_location} {
+      ++traffic().transactions;
+      ++traffic().bytes;
     }
 
     // Check we're still on speaking terms.
@@ -34,11 +96,23 @@ class Chat {
     Chat& send(byte msg) {
       if (!err) {
         ++location;
+        ++traffic().bytes;
         err = USI_TWI_Master_Send<Device>(msg);
       }
       return *this;
     }
 
+    // Address the device anew, without first releasing the bus.
+    Chat& restart() {
+      if (!err) {
+        ++location;
+        ++traffic().restarts;
+        ++traffic().bytes;
+        err = USI_TWI_Master_Start_Sending<Device>();
+      }
+      return *this;
+    }
+
     // Send the same byte many times.
     template <typename I>
     Chat& sendN(I count, byte msg) {
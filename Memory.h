@@ -0,0 +1,42 @@
+#pragma once
+#include <Arduino.h>
+
+// How much of the 512 bytes of RAM is in use. At startup, before any
+// constructors run, all RAM between the static data and the stack is painted
+// with a fixed value. Whatever the stack ever grows into gets overwritten,
+// so scanning for the paint later on tells how deep the stack has been.
+// Paints from .init3, so only include this from the sketch itself.
+namespace Memory {
+
+static uint8_t constexpr PAINT = 0xC5;
+
+extern "C" uint8_t __heap_start; // end of .data and .bss, and this sketch doesn't use a heap
+
+__attribute__((naked, used, section(".init3")))
+static void paint() {
+  uint8_t* p = &__heap_start;
+  while (p < reinterpret_cast<uint8_t*>(SP)) {
+    *p++ = PAINT;
+  }
+}
+
+// Bytes occupied by .data and .bss.
+static uint16_t staticBytes() {
+  return &__heap_start - reinterpret_cast<uint8_t*>(RAMSTART);
+}
+
+// Bytes between static data and the deepest the stack has ever been.
+static uint16_t unusedBytes() {
+  uint8_t const* p = &__heap_start;
+  while (p < reinterpret_cast<uint8_t const*>(SP) && *p == PAINT) {
+    ++p;
+  }
+  return p - &__heap_start;
+}
+
+// Bytes of stack used at its deepest.
+static uint16_t peakStackBytes() {
+  return RAMEND + 1 - (RAMSTART + staticBytes() + unusedBytes());
+}
+
+}
@@ -15,22 +15,40 @@ static constexpr byte PAYLOAD_DATA = 0x40;    // prefix to data (bitmap upload)
 static constexpr byte PAYLOAD_LASTCOM = 0x00; // prefix to command or its option(s) after which a stop will follow;
 //                                               if further data is sent anyway, the device may ignore part of it.
 
+// What sets display controllers apart, as far as we care.
+// Device types for this namespace specify theirs as a nested Controller type.
+struct SSD1306 {
+  static constexpr byte CHARGE_PUMP = 0x8D;    // command to set the charge pump…
+  static constexpr byte CHARGE_PUMP_ON = 0x14; // …enabled
+  static constexpr uint8_t COLUMN_OFFSET = 0;  // RAM column displayed leftmost
+  static constexpr bool WINDOWING = true;      // supports addressing modes and column & page windows
+};
+
+// 132 columns of RAM, page addressing only, and no wrapping from one page to the next.
+struct SH1106 {
+  static constexpr byte CHARGE_PUMP = 0xAD;
+  static constexpr byte CHARGE_PUMP_ON = 0x8B;
+  static constexpr uint8_t COLUMN_OFFSET = 2;
+  static constexpr bool WINDOWING = false;
+};
+
 enum Addressing {
   HorizontalAddressing = 0b00,
   VerticalAddressing = 0b01,
   PageAddressing = 0b10
 };
 
-// Full conversation with SSD 1306.
+// Full conversation with an SSD1306 or SH1106.
 template <typename Device>
 class Chat : public I2C::Chat<Device> {
     using super = I2C::Chat<Device>;
+    using Controller = typename Device::Controller;
   public:
     explicit Chat(uint8_t start_location) : I2C::Chat<Device>(start_location) {}
 
     Chat& init() {
-      super::send(PAYLOAD_COMMAND).send(0x8D); // Set charge pump (powering the OLED grid)…
-      super::send(PAYLOAD_COMMAND).send(0x14); // …enabled.
+      super::send(PAYLOAD_COMMAND).send(Controller::CHARGE_PUMP);    // Set charge pump (powering the OLED grid)…
+      super::send(PAYLOAD_COMMAND).send(Controller::CHARGE_PUMP_ON); // …enabled.
       return *this;
     }
 
@@ -45,12 +63,14 @@ class Chat : public I2C::Chat<Device> {
       return *this;
     }
 
+    // Only if Controller::WINDOWING.
     Chat& set_addressing_mode(Addressing mode) {
       super::send(PAYLOAD_COMMAND).send(0x20);
       super::send(PAYLOAD_COMMAND).send(mode);
       return *this;
     }
 
+    // Only if Controller::WINDOWING.
     Chat& set_column_address(uint8_t start = 0, uint8_t end = WIDTH - 1) {
       super::send(PAYLOAD_COMMAND).send(0x21);
       super::send(PAYLOAD_COMMAND).send(start);
@@ -58,6 +78,7 @@ class Chat : public I2C::Chat<Device> {
       return *this;
     }
 
+    // Only if Controller::WINDOWING.
     Chat& set_page_address(uint8_t start = 0, uint8_t end = 7) {
       super::send(PAYLOAD_COMMAND).send(0x22);
       super::send(PAYLOAD_COMMAND).send(start);
@@ -65,41 +86,123 @@ class Chat : public I2C::Chat<Device> {
       return *this;
     }
 
+    // Only if Controller::WINDOWING.
     Chat& set_page_start_address(uint8_t pageN) {
       set_addressing_mode(PageAddressing);
       super::send(PAYLOAD_COMMAND).send(byte{0xB0} | pageN);
       return *this;
     }
 
+    // Position of the next data in page addressing mode, which for an SH1106 is the only mode.
+    Chat& set_position(uint8_t page, uint8_t x) {
+      uint8_t const column = x + Controller::COLUMN_OFFSET;
+      super::send(PAYLOAD_COMMAND).send(byte{0xB0} | page);
+      super::send(PAYLOAD_COMMAND).send(byte{0x00} | (column & 0xF));
+      super::send(PAYLOAD_COMMAND).send(byte{0x10} | (column >> 4));
+      return *this;
+    }
+
     // You can only send the data and stop this chat after this.
     I2C::Chat<Device>& start_data() {
       return super::send(PAYLOAD_DATA);
     }
 };
 
+// A single transaction carrying several updates, each to its own window (or
+// position, for controllers without windowing). Between updates, a repeated
+// start replaces a stop and a new start, and a page window is only sent if it
+// changes, provided each update fills its window.
+template <typename Device>
+class Session : public Chat<Device> {
+    using super = Chat<Device>;
+
+    bool in_data = false;
+    uint8_t page_begin = 0xFF;
+    uint8_t page_end = 0xFF;
+
+    void leave_data() {
+      if (in_data) {
+        super::restart();
+        in_data = false;
+      }
+    }
+
+    I2C::Chat<Device>& enter_data() {
+      in_data = true;
+      return super::start_data();
+    }
+
+  public:
+    explicit Session(uint8_t start_location) : super(start_location) {}
+
+    // Start an update of columns xBegin to xEnd across pages pageBegin to pageEnd,
+    // which only works if Controller::WINDOWING. Send its data next.
+    I2C::Chat<Device>& window(uint8_t xBegin, uint8_t xEnd, uint8_t pageBegin = 0, uint8_t pageEnd = 7) {
+      leave_data();
+      if (pageBegin != page_begin || pageEnd != page_end) {
+        super::set_page_address(pageBegin, pageEnd);
+        page_begin = pageBegin;
+        page_end = pageEnd;
+      }
+      super::set_column_address(xBegin, xEnd);
+      return enter_data();
+    }
+
+    // Start an update of one page from pixel column x onwards. Send its data next.
+    I2C::Chat<Device>& position(uint8_t page, uint8_t x) {
+      leave_data();
+      super::set_position(page, x);
+      return enter_data();
+    }
+};
+
 // Dividing the display in four rows, each consisting of two RAM pages.
 enum class Quarter : uint8_t {
   A, B, C, D
 };
 
-// Data conversation with SSD 1306 addressing two consecutive pages.
+// Data conversation addressing two consecutive pages. Controllers with windowing
+// get both pages in a single pass, column after column. Others need to go over the
+// same content in two passes, each sending the column halves on one page.
 template <typename Device>
 class QuarterChat : public I2C::Chat<Device> {
     using super = I2C::Chat<Device>;
+    using Controller = typename Device::Controller;
+
+    static I2C::Chat<Device> start(uint8_t start_location, Quarter quarter, uint8_t xBegin, uint8_t xEnd, uint8_t pass) {
+      uint8_t const page = static_cast<uint8_t>(quarter) * 2;
+      if (Controller::WINDOWING) {
+        return OLED::Chat<Device>(start_location)
+               .set_page_address(page, page + 1)
+               .set_column_address(xBegin, xEnd)
+               .start_data();
+      } else {
+        return OLED::Chat<Device>(start_location)
+               .set_position(page + pass, xBegin)
+               .start_data();
+      }
+    }
+
+  protected:
+    uint8_t const pass;
+
   public:
-    explicit QuarterChat(uint8_t start_location, Quarter quarter, uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1)
-      : super(
-          OLED::Chat<Device>(start_location)
-          .set_page_address(static_cast<uint8_t>(quarter) * 2, static_cast<uint8_t>(quarter) * 2 + 1)
-          .set_column_address(xBegin, xEnd)
-          .start_data()
-        ) {
+    static constexpr uint8_t PASSES = Controller::WINDOWING ? 1 : 2;
+
+    explicit QuarterChat(uint8_t start_location, Quarter quarter, uint8_t xBegin = 0, uint8_t xEnd = OLED::WIDTH - 1,
+                         uint8_t pass = 0)
+      : super(start(start_location, quarter, xBegin, xEnd, pass))
+      , pass(pass) {
     }
 
     // Send one column.
     QuarterChat& send(byte b1, byte b2) {
-      super::send(b1);
-      super::send(b2);
+      if (Controller::WINDOWING || pass == 0) {
+        super::send(b1);
+      }
+      if (Controller::WINDOWING || pass == 1) {
+        super::send(b2);
+      }
       return *this;
     }
 };
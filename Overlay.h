@@ -0,0 +1,193 @@
+#pragma once
+#include "Glyph.h"
+#include "OLED.h"
+
+// A line of glyphs over one quarter of the display, composed into the bytes of
+// whatever else is being displayed, as they are sent. So it takes no separate
+// transaction or window, and nothing is ever displayed without it.
+// Glyphs are laid out like GlyphsOnQuarter sends them.
+class Overlay {
+  public:
+    enum Priority : uint8_t {
+      UNDER_BALL,
+      OVER_BALL
+    };
+
+    static constexpr uint8_t CAPACITY = 12;
+
+  private:
+    static constexpr byte HEARTBEAT_SEG1 = GlyphExtractor::extractSeg("  # # # ");
+    static constexpr byte HEARTBEAT_SEG2 = GlyphExtractor::extractSeg("# # #   ");
+
+    struct Item {
+      Glyph const* glyph; // nullptr for blank columns
+      uint8_t margin;     // blank columns on either side of the glyph, or number of blank columns
+
+      uint8_t width() const {
+        return glyph ? margin + Glyph::SEGS + margin : margin;
+      }
+    };
+
+    Item items[CAPACITY];
+    uint8_t length = 0;
+    uint8_t const page; // upper one of the two pages covered
+    uint8_t const xBegin;
+    uint8_t xEnd;
+    // Where the last column was composed from. Columns are mostly asked for in
+    // increasing order, except that a windowed flush asks for the same few
+    // columns again for the lower page.
+    uint8_t cursor_x;
+    uint8_t cursor_item;
+    uint8_t cursor_offset;
+    // Should be Priority, but that cannot be narrowed until gcc 9.3.
+    uint8_t priority_ : 1;
+    bool opaque : 1;
+    bool include_heartbeat : 1;
+    bool heartbeat : 1;
+
+    void put(Glyph const* glyph, uint8_t margin) {
+      if (length < CAPACITY && (glyph || margin)) {
+        items[length++] = Item { glyph, margin };
+        xEnd += items[length - 1].width();
+      }
+    }
+
+    void rewind() {
+      cursor_x = xBegin;
+      cursor_item = 0;
+      cursor_offset = 0;
+    }
+
+    // Both bytes for pixel column x, provided xBegin <= x < xEnd.
+    // Steps back from the cursor, or starts over if that's closer.
+    uint16_t column(uint8_t x) {
+      if (x < cursor_x) {
+        if (x - xBegin < cursor_x - x) {
+          rewind();
+        }
+        while (cursor_x > x) {
+          --cursor_x;
+          if (cursor_offset-- == 0) {
+            --cursor_item;
+            cursor_offset = items[cursor_item].width() - 1;
+          }
+        }
+      }
+      while (cursor_x < x) {
+        ++cursor_x;
+        if (++cursor_offset == items[cursor_item].width()) {
+          ++cursor_item;
+          cursor_offset = 0;
+        }
+      }
+      Item const& item = items[cursor_item];
+      uint16_t bits = 0;
+      if (item.glyph && cursor_offset >= item.margin && cursor_offset < item.margin + Glyph::SEGS) {
+        bits = uint16_t(item.glyph->seg(cursor_offset - item.margin)) << 4;
+      }
+      if (heartbeat && x == xBegin) {
+        bits |= HEARTBEAT_SEG1 | HEARTBEAT_SEG2 << 8;
+      }
+      return bits;
+    }
+
+  public:
+    // Opaque overlays blank out what's underneath, transparent ones let it show through.
+    explicit Overlay(OLED::Quarter quarter, uint8_t xBegin = 0,
+                     Priority priority = OVER_BALL, bool opaque = true, bool include_heartbeat = false)
+      : page(static_cast<uint8_t>(quarter) * 2)
+      , xBegin(xBegin)
+      , xEnd(xBegin)
+      , priority_(priority)
+      , opaque(opaque)
+      , include_heartbeat(include_heartbeat)
+      , heartbeat(false) {
+      rewind();
+    }
+
+    Priority priority() const {
+      return static_cast<Priority>(priority_);
+    }
+
+    // Toggle the heartbeat, if included, once per frame displayed.
+    void next_frame() {
+      heartbeat = include_heartbeat && !heartbeat;
+    }
+
+    // Compose this overlay into byte b, found at pixel column x of page p.
+    byte compose(uint8_t p, uint8_t x, byte b) {
+      if (uint8_t(p - page) >= 2 || x < xBegin || x >= xEnd) {
+        return b;
+      }
+      uint16_t const bits = column(x);
+      byte const mine = p == page ? byte(bits) : byte(bits >> 8);
+      return opaque ? mine : b | mine;
+    }
+
+    // Remove all glyphs, to put others.
+    Overlay& clear() {
+      length = 0;
+      xEnd = xBegin;
+      rewind();
+      return *this;
+    }
+
+    Overlay& put(uint8_t blank_columns) {
+      put(nullptr, blank_columns);
+      return *this;
+    }
+
+    Overlay& put(Glyph const& glyph, uint8_t margin = 0) {
+      put(&glyph, margin);
+      return *this;
+    }
+
+    Overlay& put(GlyphPair const& pair) {
+      put(&pair.left, 0);
+      put(&pair.right, 0);
+      return *this;
+    }
+
+    Overlay& put3dec(uint8_t number) {
+      uint8_t p1 = number / 100;
+      uint8_t p2 = number % 100;
+      if (p1 != 0) {
+        put(Glyph::dec_digit[p1], Glyph::DIGIT_MARGIN);
+      } else {
+        put(Glyph::DIGIT_WIDTH);
+      }
+      if (p1 != 0 || p2 >= 10) {
+        put(Glyph::dec_digit[p2 / 10], Glyph::DIGIT_MARGIN);
+      } else {
+        put(Glyph::DIGIT_WIDTH);
+      }
+      put(Glyph::dec_digit[p2 % 10], Glyph::DIGIT_MARGIN);
+      return *this;
+    }
+
+    // Unlike GlyphsOnQuarter::send4dec, shows only 0 to 9999.
+    Overlay& put4dec(uint16_t number) {
+      if (number >= 10000) {
+        number = 9999;
+      }
+      uint8_t p1 = number / 100;
+      uint8_t p2 = number % 100;
+      if (p1 >= 10) {
+        put(Glyph::dec_digit[p1 / 10], Glyph::DIGIT_MARGIN);
+      } else {
+        put(Glyph::DIGIT_WIDTH);
+      }
+      if (p1 != 0) {
+        put(Glyph::dec_digit[p1 % 10], Glyph::DIGIT_MARGIN);
+      } else {
+        put(Glyph::DIGIT_WIDTH);
+      }
+      if (p1 != 0 || p2 >= 10) {
+        put(Glyph::dec_digit[p2 / 10], Glyph::DIGIT_MARGIN);
+      } else {
+        put(Glyph::DIGIT_WIDTH);
+      }
+      put(Glyph::dec_digit[p2 % 10], Glyph::DIGIT_MARGIN);
+      return *this;
+    }
+};
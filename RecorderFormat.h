@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+
+// Layout of the flight recorder in EEPROM, shared by the sketch and the host decoder.
+// The EEPROM is a ring of fixed size slots, written one after the other so that
+// wear is spread evenly. A record's sequence number follows the previous one's,
+// so the most recent record is found where the sequence breaks.
+namespace Recorder {
+
+static uint16_t constexpr EEPROM_BYTES = 512;
+
+enum Kind : uint8_t {
+  FAULT = 'E', // uint8_t error, location, ball y, x, yDir, xDir
+  RATE = 'R',  // uint16_t frames, ms per frame, bus errors so far; sampled periodically
+  ERASED = 0xFF,
+};
+
+struct Record {
+  uint8_t kind;    // written last, so that a record interrupted by power loss reads as ERASED
+  uint8_t seq;
+  uint8_t payload[6];
+};
+
+static uint8_t constexpr SLOTS = EEPROM_BYTES / sizeof(Record);
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <Arduino.h>
+
+// Refreshing parts of the display each at their own rate, instead of all of it
+// every frame. Each frame, regions that are due are flushed in order of priority,
+// for as long as their estimated bus bytes fit in the budget of the frame.
+// A region skipped for PATIENCE frames in a row goes regardless of the budget,
+// so that a big region that never fits still gets its turn.
+// Regions are in pixel columns and pages, like windows. Times are kept in the
+// lower 16 bits of milliseconds, so periods must stay well below a minute.
+template <uint8_t CAPACITY>
+class RegionScheduler {
+  public:
+    // Bus bytes spent on opening a window within a transaction: the repeated
+    // start and address, 2 * 3 command bytes with their prefixes, and the data prefix.
+    static uint8_t constexpr WINDOW_COST = 1 + 2 * 2 * 3 + 1;
+    static uint8_t constexpr PATIENCE = 8;
+
+    struct Region {
+      uint8_t xBegin;
+      uint8_t xEnd;
+      uint8_t pageBegin;
+      uint8_t pageEnd;
+      uint16_t period_ms;
+      uint8_t priority; // lower goes first
+      uint8_t skipped;  // frames due but not flushed, in a row
+      uint16_t due_ms;
+      // Since the last report
+      uint16_t refreshes;
+      uint8_t most_skipped;
+      uint16_t report_ms;
+
+      uint16_t cost() const {
+        return WINDOW_COST + uint16_t(xEnd - xBegin + 1) * (pageEnd - pageBegin + 1);
+      }
+    };
+
+  private:
+    Region regions[CAPACITY];
+    uint8_t order[CAPACITY]; // indices of regions by priority
+    uint8_t length = 0;
+
+  public:
+    // Add a region and return its index, which is how it is referred to.
+    uint8_t add(uint8_t xBegin, uint8_t xEnd, uint8_t pageBegin, uint8_t pageEnd,
+                uint16_t period_ms, uint8_t priority) {
+      uint8_t const index = length++;
+      regions[index] = Region { xBegin, xEnd, pageBegin, pageEnd, period_ms, priority, 0, 0, 0, 0, 0 };
+      uint8_t i = index;
+      for (; i > 0 && regions[order[i - 1]].priority > priority; --i) {
+        order[i] = order[i - 1];
+      }
+      order[i] = index;
+      return index;
+    }
+
+    Region const& operator[](uint8_t index) const {
+      return regions[index];
+    }
+
+    // Change the area of a region, such as one following the ball.
+    void move(uint8_t index, uint8_t xBegin, uint8_t xEnd, uint8_t pageBegin, uint8_t pageEnd) {
+      Region& r = regions[index];
+      r.xBegin = xBegin;
+      r.xEnd = xEnd;
+      r.pageBegin = pageBegin;
+      r.pageEnd = pageEnd;
+    }
+
+    // Count a region as flushed, after it was flushed as part of something else.
+    void flushed(uint8_t index, unsigned long now_ms) {
+      Region& r = regions[index];
+      r.due_ms = uint16_t(now_ms) + r.period_ms;
+      r.skipped = 0;
+      ++r.refreshes;
+    }
+
+    // Flush the regions due at now_ms that fit in budget bus bytes, by calling
+    // flush(region), until that returns false.
+    template <typename Flush>
+    bool run(unsigned long now_ms, uint16_t budget, Flush flush) {
+      for (uint8_t i = 0; i < length; ++i) {
+        uint8_t const index = order[i];
+        Region& r = regions[index];
+        if (int16_t(uint16_t(now_ms) - r.due_ms) < 0) {
+          continue;
+        }
+        uint16_t const cost = r.cost();
+        if (cost <= budget || r.skipped >= PATIENCE) {
+          budget = cost <= budget ? budget - cost : 0;
+          if (!flush(r)) {
+            return false;
+          }
+          flushed(index, now_ms);
+        } else {
+          ++r.skipped;
+          if (r.skipped > r.most_skipped) {
+            r.most_skipped = r.skipped;
+          }
+        }
+      }
+      return true;
+    }
+
+    // Pass how a region has been keeping up since the last time it was reported
+    // to report(period_ms, refreshes, elapsed_ms, most_skipped).
+    // Each region must be reported at least once a minute.
+    template <typename Report>
+    void report(uint8_t index, unsigned long now_ms, Report report) {
+      Region& r = regions[index];
+      report(r.period_ms, r.refreshes, uint16_t(uint16_t(now_ms) - r.report_ms), r.most_skipped);
+      r.refreshes = 0;
+      r.most_skipped = 0;
+      r.report_ms = uint16_t(now_ms);
+    }
+
+    uint8_t size() const {
+      return length;
+    }
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+// The room and the ball bouncing through it, apart from how they are displayed,
+// so that they can also be compiled for a host.
+
+// Terminology:
+// - "row" & "col" apply to the coarse grid defining the room
+// - "Y" and "X" refer to the rows and columns of actual pixels
+static uint8_t constexpr X_PER_COL = 4;
+static uint8_t constexpr Y_PER_ROW = 4;
+static uint8_t constexpr COLS = 128 / X_PER_COL;
+static uint8_t constexpr ROWS = 64 / Y_PER_ROW;
+
+struct Ball {
+  uint8_t y;
+  uint8_t x;
+  int8_t yDir;
+  int8_t xDir;
+};
+
+static uint8_t const room_shape[ROWS * COLS] PROGMEM = {
+  1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 2 , 2, 2, 2, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 2, 2, 2, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 2, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 2, 0, 0, 0 , 0, 0, 0, 0, 2, 2, 2, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 2, 2, 2, 2, 0, 0, 0 , 0, 2, 0, 0, 0, 0, 0, 2 , 2, 2, 2, 2, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 2, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 0 , 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1 , 1, 1, 1, 1, 1, 1, 1, 1,
+};
+
+// The room as it was drawn: 0 for space, 1 for the outer wall, 2 for inner walls.
+static uint8_t getWall(uint8_t row, uint8_t col) {
+  return pgm_read_byte(&room_shape[row * COLS + col]);
+}
+
+struct Cell {
+  uint8_t row;
+  uint8_t col;
+};
+
+// The walls as they are now, a bit per cell, so that inner walls can be knocked
+// down. Each column takes BYTES_PER_COL bytes, with row r in bit r % 8 of byte
+// r / 8, like pixels in the pages of the display. Looking up a cell costs a RAM
+// load for the byte and one for the bit, instead of a program memory load.
+// To stay as fast as getWall(), the byte is indexed in 8 bits, and the bit is
+// looked up by the whole row rather than masking it first. host/lookup_cycles.py
+// counts the cycles of both.
+class WallMap {
+  public:
+    static uint8_t constexpr BYTES_PER_COL = (ROWS + 7) / 8;
+    static uint8_t constexpr MAX_CHANGES = 4; // as many as one move can make
+
+  private:
+    static_assert(COLS * BYTES_PER_COL <= 256, "byte index must fit in 8 bits");
+    static_assert(ROWS == 16, "bit table must cover every row");
+
+    uint8_t bits[COLS * BYTES_PER_COL];
+    Cell changes[MAX_CHANGES];
+    uint8_t change_count;
+
+    static uint8_t index(uint8_t row, uint8_t col) {
+      return uint8_t(col * BYTES_PER_COL + (row >> 3));
+    }
+
+    static uint8_t bit(uint8_t row) {
+      static uint8_t const BIT[ROWS] = {
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+      };
+      return BIT[row];
+    }
+
+
+  public:
+    void reset() {
+      for (uint8_t col = 0; col < COLS; ++col) {
+        for (uint8_t b = 0; b < BYTES_PER_COL; ++b) {
+          bits[col * BYTES_PER_COL + b] = 0;
+        }
+        for (uint8_t row = 0; row < ROWS; ++row) {
+          if (getWall(row, col)) {
+            bits[index(row, col)] |= bit(row);
+          }
+
+        }
+      }
+      change_count = 0;
+    }
+
+    bool operator()(uint8_t row, uint8_t col) const {
+      return bits[index(row, col)] & bit(row);
+
+    }
+
+    // Knock down the wall at a cell, if it's an inner wall, and remember the cell changed.
+    void hit(uint8_t row, uint8_t col) {
+      if (getWall(row, col) == 2 && (*this)(row, col) && change_count < MAX_CHANGES) {
+        bits[index(row, col)] &= ~bit(row);
+
+        changes[change_count++] = Cell { row, col };
+      }
+    }
+
+    // Cells changed since the last call, until it returns false.
+    bool changed(Cell& cell) {
+      if (change_count == 0) {
+        return false;
+      }
+      cell = changes[--change_count];
+      return true;
+    }
+
+    void forget_changes() {
+      change_count = 0;
+    }
+};
+
+// Move the ball one step, bouncing off walls, and knocking them down if destroy.
+// Returns false if the ball is trapped between walls.
+static inline bool move(Ball& ball, WallMap& walls, bool destroy = false) {
+
+  for (uint8_t twice = 0; twice < 2; ++twice) {
+    // We consider the ball to be a square for collision detection.
+    // When moving in a positive direction, add the size of the ball
+    // because that's the edge of the square possibly hitting a wall.
+    uint8_t const edgeY = ball.y + ball.yDir + (ball.yDir < 0 ? 0 : Y_PER_ROW - 1);
+    uint8_t const edgeX = ball.x + ball.xDir + (ball.xDir < 0 ? 0 : X_PER_COL - 1);
+    bool const yHit = walls(edgeY / Y_PER_ROW, ball.x / X_PER_COL);
+    bool const xHit = walls(ball.y / Y_PER_ROW, edgeX / X_PER_COL);
+    if (yHit) {
+      ball.yDir = -ball.yDir;
+      if (destroy) {
+        walls.hit(edgeY / Y_PER_ROW, ball.x / X_PER_COL);
+      }
+    }
+    if (xHit) {
+      ball.xDir = -ball.xDir;
+      if (destroy) {
+        walls.hit(ball.y / Y_PER_ROW, edgeX / X_PER_COL);
+      }
+    }
+    if (!yHit && !xHit) {
+      ball.y += ball.yDir;
+      ball.x += ball.xDir;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "OLED.h"
+#include "Room.h"
+
+// The cheapest way to get the room across, given what the controller supports.
+// Flushing is done in STEPS steps, and display resumes from a given step.
+// Compose::cells(c, rp, out, stride) provides the display bytes of page rp of
+// the pixel columns in cell column c, storing them stride bytes apart.
+template <typename Device, typename Compose, bool WINDOWING = Device::Controller::WINDOWING>
+struct RoomFlush;
+
+// With windowing: column after column across all pages, in a single transaction.
+// Steps are cell columns.
+template <typename Device, typename Compose>
+struct RoomFlush<Device, Compose, true> {
+  static uint8_t constexpr STEPS = COLS;
+
+  static OLED::Chat<Device>& prepare(OLED::Chat<Device>& chat) {
+    return chat
+           .set_addressing_mode(OLED::VerticalAddressing)
+           .set_column_address()
+           .set_page_address();
+  }
+
+  static I2C::Status display(uint8_t& c) {
+    // Whatever window was left behind, by regions or by an interrupted frame,
+    // the frame sets its own, from where it is to resume.
+    auto chat = OLED::Chat<Device>(20);
+    auto& data = chat.set_column_address(c * X_PER_COL).set_page_address().start_data();
+    for (; c < COLS; c += 1) {
+      uint8_t buf[OLED::BYTES_PER_SEG * X_PER_COL];
+      for (uint8_t rp = 0; rp < OLED::BYTES_PER_SEG; rp += 1) {
+        Compose::cells(c, rp, &buf[rp], OLED::BYTES_PER_SEG);
+      }
+      for (uint8_t i = 0; i < sizeof buf; ++i) {
+        data.send(buf[i]);
+      }
+      if (!data) {
+        break;
+      }
+    }
+    return data.stop();
+  }
+
+  // Send a region of whole cell columns, in a window of its own.
+  static bool region(OLED::Session<Device>& session, uint8_t xBegin, uint8_t xEnd, uint8_t pBegin, uint8_t pEnd) {
+    auto& data = session.window(xBegin, xEnd, pBegin, pEnd);
+    uint8_t const pages = pEnd - pBegin + 1;
+    for (uint8_t c = xBegin / X_PER_COL; c <= xEnd / X_PER_COL; c += 1) {
+      uint8_t buf[OLED::BYTES_PER_SEG * X_PER_COL];
+      for (uint8_t rp = pBegin; rp <= pEnd; rp += 1) {
+        Compose::cells(c, rp, &buf[rp - pBegin], pages);
+      }
+      for (uint8_t i = 0; i < pages * X_PER_COL; ++i) {
+        data.send(buf[i]);
+      }
+    }
+    return data;
+  }
+};
+
+// Without windowing nor wrapping to the next page: page after page, each
+// positioned anew, in a single transaction. Steps are pages.
+template <typename Device, typename Compose>
+struct RoomFlush<Device, Compose, false> {
+  static uint8_t constexpr STEPS = OLED::BYTES_PER_SEG;
+
+  static OLED::Chat<Device>& prepare(OLED::Chat<Device>& chat) {
+    return chat;
+  }
+
+  static I2C::Status display(uint8_t& rp) {
+    OLED::Session<Device> session(20);
+    for (; rp < OLED::BYTES_PER_SEG; rp += 1) {
+      auto& data = session.position(rp, 0);
+      for (uint8_t c = 0; c < COLS; c += 1) {
+        uint8_t buf[X_PER_COL];
+        Compose::cells(c, rp, buf, 1);
+        for (uint8_t i = 0; i < sizeof buf; ++i) {
+          data.send(buf[i]);
+        }
+      }
+      if (!data) {
+        break;
+      }
+    }
+    return session.stop();
+  }
+
+  // Send a region of whole cell columns, positioned anew on each page.
+  static bool region(OLED::Session<Device>& session, uint8_t xBegin, uint8_t xEnd, uint8_t pBegin, uint8_t pEnd) {
+    for (uint8_t rp = pBegin; rp <= pEnd; rp += 1) {
+      auto& data = session.position(rp, xBegin);
+      for (uint8_t c = xBegin / X_PER_COL; c <= xEnd / X_PER_COL; c += 1) {
+        uint8_t buf[X_PER_COL];
+        Compose::cells(c, rp, buf, 1);
+        for (uint8_t i = 0; i < sizeof buf; ++i) {
+          data.send(buf[i]);
+        }
+      }
+      if (!data) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
@@ -0,0 +1,47 @@
+#pragma once
+// Generated by host/encode_animation.py from splash/ball0.pbm splash/ball1.pbm splash/ball2.pbm splash/ball3.pbm splash/ball4.pbm.
+// frame 0: 209 bytes encoded, 1038 bytes on the bus
+// frame 1: 157 bytes encoded, 270 bytes on the bus
+// frame 2: 85 bytes encoded, 206 bytes on the bus
+// frame 3: 55 bytes encoded, 142 bytes on the bus
+// frame 4: 25 bytes encoded, 94 bytes on the bus
+// 531 bytes instead of 5120, compression ratio 9.6
+#include <Arduino.h>
+
+static uint8_t constexpr SPLASH_FRAMES = 5;
+static uint8_t const splash[] PROGMEM = {
+  0x00, 0x7F, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x82, 0x00, 0x01, 0xF0, 0x0F, 0x85, 0x00, 0x01,
+  0xFE, 0x7F, 0x84, 0x00, 0x03, 0x80, 0xFF, 0xFF, 0x01, 0x83, 0x00, 0x03, 0xC0, 0xFF, 0xFF, 0x03,
+  0x83, 0x00, 0x03, 0xE0, 0xFF, 0xFF, 0x07, 0x83, 0x00, 0x03, 0xF0, 0xFF, 0xFF, 0x0F, 0x83, 0x00,
+  0x03, 0xF8, 0xFF, 0xFF, 0x1F, 0x83, 0x00, 0x03, 0xFC, 0xFF, 0xFF, 0x3F, 0x83, 0x00, 0x03, 0xFC,
+  0xFF, 0xFF, 0x3F, 0x83, 0x00, 0x03, 0xFE, 0xFF, 0xFF, 0x7F, 0x83, 0x00, 0x03, 0xFE, 0xFF, 0xFF,
+  0x7F, 0x83, 0x00, 0x03, 0xFE, 0xFF, 0xFF, 0x7F, 0x83, 0x00, 0x83, 0xFF, 0x83, 0x00, 0x83, 0xFF,
+  0x83, 0x00, 0x83, 0xFF, 0x83, 0x00, 0x83, 0xFF, 0x83, 0x00, 0x83, 0xFF, 0x83, 0x00, 0x83, 0xFF,
+  0x83, 0x00, 0x83, 0xFF, 0x83, 0x00, 0x83, 0xFF, 0x83, 0x00, 0x03, 0xFE, 0xFF, 0xFF, 0x7F, 0x83,
+  0x00, 0x03, 0xFE, 0xFF, 0xFF, 0x7F, 0x83, 0x00, 0x03, 0xFE, 0xFF, 0xFF, 0x7F, 0x83, 0x00, 0x03,
+  0xFC, 0xFF, 0xFF, 0x3F, 0x83, 0x00, 0x03, 0xFC, 0xFF, 0xFF, 0x3F, 0x83, 0x00, 0x03, 0xF8, 0xFF,
+  0xFF, 0x1F, 0x83, 0x00, 0x03, 0xF0, 0xFF, 0xFF, 0x0F, 0x83, 0x00, 0x03, 0xE0, 0xFF, 0xFF, 0x07,
+  0x83, 0x00, 0x03, 0xC0, 0xFF, 0xFF, 0x03, 0x83, 0x00, 0x03, 0x80, 0xFF, 0xFF, 0x01, 0x84, 0x00,
+  0x01, 0xFE, 0x7F, 0x85, 0x00, 0x01, 0xF0, 0x0F, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x82, 0x00,
+  0xFF, 0x30, 0x4F, 0xA2, 0x00, 0x01, 0xE0, 0x07, 0x85, 0x00, 0x01, 0xFC, 0x3F, 0x85, 0x00, 0x01,
+  0xFE, 0x7F, 0x85, 0x00, 0x01, 0xFF, 0xFF, 0x84, 0x00, 0x03, 0x80, 0xFF, 0xFF, 0x01, 0x83, 0x00,
+  0x03, 0xC0, 0xFF, 0xFF, 0x03, 0x83, 0x00, 0x03, 0xE0, 0xFF, 0xFF, 0x07, 0x83, 0x00, 0x03, 0xE0,
+  0xFF, 0xFF, 0x07, 0x83, 0x00, 0x03, 0xE0, 0xFF, 0xFF, 0x07, 0x83, 0x00, 0x03, 0xF0, 0xFF, 0xFF,
+  0x0F, 0x83, 0x00, 0x03, 0xF0, 0xFF, 0xFF, 0x0F, 0x83, 0x00, 0x03, 0xF0, 0xFF, 0xFF, 0x0F, 0x83,
+  0x00, 0x03, 0xF0, 0xFF, 0xFF, 0x0F, 0x83, 0x00, 0x03, 0xF0, 0xFF, 0xFF, 0x0F, 0x83, 0x00, 0x03,
+  0xF0, 0xFF, 0xFF, 0x0F, 0x83, 0x00, 0x03, 0xE0, 0xFF, 0xFF, 0x07, 0x83, 0x00, 0x03, 0xE0, 0xFF,
+  0xFF, 0x07, 0x83, 0x00, 0x03, 0xE0, 0xFF, 0xFF, 0x07, 0x83, 0x00, 0x03, 0xC0, 0xFF, 0xFF, 0x03,
+  0x83, 0x00, 0x03, 0x80, 0xFF, 0xFF, 0x01, 0x84, 0x00, 0x01, 0xFF, 0xFF, 0x85, 0x00, 0x01, 0xFE,
+  0x7F, 0x85, 0x00, 0x01, 0xFC, 0x3F, 0x85, 0x00, 0x01, 0xE0, 0x07, 0xA2, 0x00, 0xFF, 0x34, 0x4B,
+  0xA2, 0x00, 0x01, 0xE0, 0x07, 0x85, 0x00, 0x01, 0xF8, 0x1F, 0x85, 0x00, 0x01, 0xFC, 0x3F, 0x85,
+  0x00, 0x01, 0xFE, 0x7F, 0x85, 0x00, 0x01, 0xFE, 0x7F, 0x85, 0x00, 0x01, 0xFF, 0xFF, 0x85, 0x00,
+  0x01, 0xFF, 0xFF, 0x85, 0x00, 0x01, 0xFF, 0xFF, 0x85, 0x00, 0x01, 0xFF, 0xFF, 0x85, 0x00, 0x01,
+  0xFF, 0xFF, 0x85, 0x00, 0x01, 0xFF, 0xFF, 0x85, 0x00, 0x01, 0xFE, 0x7F, 0x85, 0x00, 0x01, 0xFE,
+  0x7F, 0x85, 0x00, 0x01, 0xFC, 0x3F, 0x85, 0x00, 0x01, 0xF8, 0x1F, 0x85, 0x00, 0x01, 0xE0, 0x07,
+  0xA2, 0x00, 0xFF, 0x38, 0x47, 0x9A, 0x00, 0x01, 0xC0, 0x03, 0x85, 0x00, 0x01, 0xF0, 0x0F, 0x85,
+  0x00, 0x01, 0xF0, 0x0F, 0x85, 0x00, 0x01, 0xF8, 0x1F, 0x85, 0x00, 0x01, 0xF8, 0x1F, 0x85, 0x00,
+  0x01, 0xF8, 0x1F, 0x85, 0x00, 0x01, 0xF8, 0x1F, 0x85, 0x00, 0x01, 0xF0, 0x0F, 0x85, 0x00, 0x01,
+  0xF0, 0x0F, 0x85, 0x00, 0x01, 0xC0, 0x03, 0x9A, 0x00, 0xFF, 0x3B, 0x44, 0x9A, 0x00, 0x01, 0xC0,
+  0x03, 0x85, 0x00, 0x01, 0xC0, 0x03, 0x85, 0x00, 0x01, 0xC0, 0x03, 0x85, 0x00, 0x01, 0xC0, 0x03,
+  0x9A, 0x00, 0xFF,
+};
@@ -0,0 +1,135 @@
+#pragma once
+#include "I2C.h"
+#include "TelemetryFormat.h"
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+// Transmit-only serial line (8N1) on a spare pin, bit-banged by the Timer1
+// interrupt from a small queue, so that queueing a record never waits for the line.
+// Defines the interrupt handler, so only include this from the sketch itself.
+namespace Telemetry {
+
+static uint8_t constexpr PIN = PB3;
+static unsigned long constexpr BAUD = 9600;
+static uint8_t constexpr QUEUE_SIZE = 32; // must be a power of 2
+
+// Timer1 clock select for the smallest prescaler leaving at most 256 ticks per bit.
+static constexpr uint8_t clockSelect(unsigned long ticks, uint8_t cs = 1) {
+  return ticks <= 256 ? cs : clockSelect(ticks / 2, cs + 1);
+}
+static unsigned long constexpr TICKS_PER_BIT = (F_CPU + BAUD / 2) / BAUD;
+static uint8_t constexpr CLOCK_SELECT = clockSelect(TICKS_PER_BIT);
+static uint8_t constexpr TOP = (TICKS_PER_BIT >> (CLOCK_SELECT - 1)) - 1;
+
+static uint8_t queue[QUEUE_SIZE];
+static uint8_t volatile head;   // where the next byte is queued, only changed by the sketch
+static uint8_t volatile tail;   // where the next byte is dequeued, only changed by the interrupt
+static uint16_t shifter;        // bits still to be put on the line, only used by the interrupt
+static uint16_t dropped;        // records that didn't fit in the queue
+
+static void begin() {
+  digitalWrite(PIN, HIGH);
+  pinMode(PIN, OUTPUT);
+  TCCR1 = (1 << CTC1) | (CLOCK_SELECT << CS10);
+  OCR1C = TOP;
+  OCR1A = TOP;
+}
+
+// Queue a record, or count it as dropped if it doesn't fit.
+static void send(Kind kind, uint8_t const* payload) {
+  uint8_t const size = payloadSize(kind);
+  uint8_t const room = (tail - head - 1) & (QUEUE_SIZE - 1);
+  if (room < OVERHEAD + size) {
+    ++dropped;
+    return;
+  }
+  uint8_t h = head;
+  uint8_t sum = kind;
+  queue[h] = SYNC;
+  h = (h + 1) & (QUEUE_SIZE - 1);
+  queue[h] = kind;
+  h = (h + 1) & (QUEUE_SIZE - 1);
+  for (uint8_t i = 0; i < size; ++i) {
+    sum += payload[i];
+    queue[h] = payload[i];
+    h = (h + 1) & (QUEUE_SIZE - 1);
+  }
+  queue[h] = -sum;
+  h = (h + 1) & (QUEUE_SIZE - 1);
+  head = h;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    TIMSK |= (1 << OCIE1A);
+  }
+}
+
+static void sendFrame(uint16_t frame, uint16_t move_us, uint16_t display_us, I2C::Traffic const& traffic) {
+  uint16_t const payload[] = { frame, move_us, display_us, traffic.bytes, traffic.transactions, traffic.restarts };
+  send(FRAME, reinterpret_cast<uint8_t const*>(payload));
+}
+
+static void sendStatus(I2C::Status status) {
+  uint8_t const payload[] = { status.error, status.location };
+  send(STATUS, payload);
+}
+
+static void sendBus(uint16_t errors, uint16_t recoveries, uint16_t worst_recovery_us) {
+  uint16_t const payload[] = { errors, recoveries, worst_recovery_us, dropped };
+  send(BUS, reinterpret_cast<uint8_t const*>(payload));
+}
+
+static void sendMemory(uint16_t static_bytes, uint16_t peak_stack_bytes, uint16_t unused_bytes) {
+  uint16_t const payload[] = { static_bytes, peak_stack_bytes, unused_bytes };
+  send(MEMORY, reinterpret_cast<uint8_t const*>(payload));
+}
+
+static void sendAnimation(uint16_t encoded_bytes, uint16_t bus_bytes, uint16_t decode_cycles_per_byte) {
+  uint16_t const payload[] = { encoded_bytes, bus_bytes, decode_cycles_per_byte };
+  send(ANIMATION, reinterpret_cast<uint8_t const*>(payload));
+}
+
+static void sendScene(uint16_t primitives, uint16_t bus_bytes, uint16_t raster_cycles_per_column) {
+  uint16_t const payload[] = { primitives, bus_bytes, raster_cycles_per_column };
+  send(SCENE, reinterpret_cast<uint8_t const*>(payload));
+}
+
+static void sendRegion(uint8_t region, uint8_t most_skipped, uint16_t period_ms, uint16_t refreshes, uint16_t elapsed_ms) {
+  uint8_t const payload[] = {
+    region, most_skipped,
+    uint8_t(period_ms), uint8_t(period_ms >> 8),
+    uint8_t(refreshes), uint8_t(refreshes >> 8),
+    uint8_t(elapsed_ms), uint8_t(elapsed_ms >> 8),
+  };
+  send(REGION, payload);
+}
+
+static void sendGeometry(uint8_t x_per_col, uint8_t y_per_row, uint16_t cycles_per_column) {
+  uint8_t const payload[] = { x_per_col, y_per_row, uint8_t(cycles_per_column), uint8_t(cycles_per_column >> 8) };
+  send(GEOMETRY, payload);
+}
+
+static void sendWalls(uint16_t progmem_tenths, uint16_t map_tenths, uint16_t loop_tenths) {
+  uint16_t const payload[] = { progmem_tenths, map_tenths, loop_tenths };
+  send(WALLS, reinterpret_cast<uint8_t const*>(payload));
+}
+
+}
+
+ISR(TIMER1_COMPA_vect) {
+  using namespace Telemetry;
+  if (!shifter) {
+    uint8_t const t = tail;
+    if (t == head) {
+      TIMSK &= ~(1 << OCIE1A); // line stays idle until the next record
+      return;
+    }
+    shifter = queue[t] << 1 | 1 << 9; // start bit, data bits LSB first, stop bit
+    tail = (t + 1) & (QUEUE_SIZE - 1);
+  }
+  if (shifter & 1) {
+    PORTB |= (1 << PIN);
+  } else {
+    PORTB &= ~(1 << PIN);
+  }
+  shifter >>= 1;
+}
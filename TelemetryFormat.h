@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+
+// Layout of the telemetry stream, shared by the sketch and the host decoder.
+// Each record consists of:
+// - SYNC,
+// - the kind of record,
+// - the payload, a fixed number of bytes per kind, in little endian order,
+// - a checksum byte that makes kind, payload and checksum add up to zero.
+namespace Telemetry {
+
+static uint8_t constexpr SYNC = 0xA5;
+static uint8_t constexpr OVERHEAD = 3; // bytes per record besides payload
+
+enum Kind : uint8_t {
+  FRAME = 'F',  // uint16_t frame number, move µs, display µs, bus bytes, transactions, repeated starts
+  STATUS = 'S', // uint8_t error, location of a failed I2C conversation
+  BUS = 'B',    // uint16_t errors, recoveries, worst recovery µs, dropped records
+  MEMORY = 'M', // uint16_t bytes of static data, peak stack, never used
+  ANIMATION = 'A', // uint16_t bytes encoded, bus bytes, decode cycles per displayed byte
+  SCENE = 'L',    // uint16_t primitives in the display list, bus bytes, raster cycles per pixel column
+  REGION = 'R',   // uint8_t region, most frames skipped in a row, uint16_t target period ms, refreshes, over ms
+  GEOMETRY = 'G', // uint8_t pixel columns per cell, pixel rows per cell, uint16_t compose cycles per pixel column
+  WALLS = 'W',    // uint16_t tenths of cycles per wall lookup from program memory, from the wall map, for the loop alone
+};
+
+static constexpr uint8_t payloadSize(uint8_t kind) {
+  return kind == FRAME ? 12
+         : kind == STATUS ? 2
+         : kind == BUS ? 8
+         : kind == MEMORY ? 6
+         : kind == ANIMATION ? 6
+         : kind == SCENE ? 6
+         : kind == REGION ? 8
+         : kind == GEOMETRY ? 4
+         : kind == WALLS ? 6
+         : 0;
+}
+
+}
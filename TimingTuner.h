@@ -0,0 +1,106 @@
+#pragma once
+#include "OLED.h"
+
+namespace OLED {
+
+// Finds the tightest I2C timing a particular panel copes with. Starting from the
+// specification, each delay in turn is cut down step by step, while the delays
+// tuned before it stay at the lowest they passed with and those after it stay at
+// the specification. At each step, the panel has to acknowledge every byte of a
+// number of full frames of test patterns. The SSD1306 cannot be read back over
+// I2C, so acknowledgement is all we can verify.
+template <typename Panel, typename Timing>
+struct TimingTuner {
+  using Device = I2C::TunableDevice<Panel>;
+
+  enum Delay : uint8_t {
+    HSTART,
+    SSTOP,
+    IDLE,
+    PRE_SCL_HIGH,
+    POST_SCL_HIGH,
+    POST_TRANSFER,
+    DELAYS
+  };
+
+  static constexpr uint8_t STEP = 10; // percent
+
+  // The cycles of each delay according to Timing.
+  static constexpr unsigned long SPEC[DELAYS] = {
+    Timing::tHSTART.in_cycles(),
+    Timing::tSSTOP.in_cycles(),
+    Timing::tIDLE.in_cycles(),
+    Timing::tPRE_SCL_HIGH.in_cycles(),
+    Timing::tPOST_SCL_HIGH.in_cycles(),
+    Timing::tPOST_TRANSFER.in_cycles(),
+  };
+
+  static USI_TWI_Variable_Delay& delay(uint8_t d) {
+    switch (d) {
+      case HSTART: return Device::tHSTART;
+      case SSTOP: return Device::tSSTOP;
+      case IDLE: return Device::tIDLE;
+      case PRE_SCL_HIGH: return Device::tPRE_SCL_HIGH;
+      case POST_SCL_HIGH: return Device::tPOST_SCL_HIGH;
+      default: return Device::tPOST_TRANSFER;
+    }
+  }
+
+  static void set(uint8_t d, uint8_t percent) {
+    delay(d).set(SPEC[d] * percent / 100);
+  }
+
+  // Returns how many of the frames failed with the delays as they are set.
+  static uint8_t errors(uint8_t frames) {
+    static constexpr byte PATTERNS[] = { 0x55, 0xAA, 0x00, 0xFF };
+    uint8_t failed = 0;
+    for (uint8_t f = 0; f < frames; ++f) {
+      // Wherever the controller's position happens to be, it's the acknowledgement that counts.
+      auto chat = Chat<Device>(0).start_data();
+      for (uint16_t i = 0; i < BYTES; ++i) {
+        chat.send(PATTERNS[(i + f) % sizeof PATTERNS]);
+      }
+      if (chat.stop().error) {
+        ++failed;
+        USI_TWI_Master_Stop<Device>();
+        USI_TWI_Master_Initialise();
+      }
+    }
+    return failed;
+  }
+
+  // Fills in the lowest percentage of each delay at which all frames came across,
+  // and leaves the delays set to that. Returns false if even the specification
+  // doesn't get through, in which case the delays are left at the specification.
+  static bool tune(uint8_t frames, uint8_t (&percents)[DELAYS]) {
+    for (uint8_t d = 0; d < DELAYS; ++d) {
+      percents[d] = 100;
+      set(d, 100);
+    }
+    if (errors(frames) != 0) {
+      return false;
+    }
+    for (uint8_t d = 0; d < DELAYS; ++d) {
+      if (SPEC[d] == 0) {
+        percents[d] = 0;
+        continue;
+      }
+      while (percents[d] >= STEP) {
+        set(d, percents[d] - STEP);
+        if (errors(frames) != 0) {
+          break;
+        }
+        percents[d] -= STEP;
+      }
+      set(d, percents[d]);
+      // Whatever the failed step left the panel in, one more frame gets it back in step.
+      errors(1);
+    }
+    return true;
+  }
+};
+
+template <typename Panel, typename Timing>
+constexpr unsigned long TimingTuner<Panel, Timing>::SPEC[];
+
+}
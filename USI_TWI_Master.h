@@ -1,5 +1,7 @@
 #pragma once
 #include <math.h>
+#include <stdint.h>
+#include <util/delay_basic.h>
 
 /*****************************************************************************
   Based on https://github.com/adafruit/TinyWireM
@@ -113,17 +115,52 @@ static unsigned char constexpr USI_TWI_Prefix(USI_TWI_Direction direction, unsig
 class USI_TWI_Delay {
     unsigned long const cycles;
 
+    struct Cycles {};
+    constexpr USI_TWI_Delay(Cycles, unsigned long cycles) : cycles(cycles) {}
+
   public:
     constexpr USI_TWI_Delay(double us)
       : cycles(us <= 0 ? 0 : ceil(us / 1e6 * F_CPU) - 1)
         // - 1 because whatever we did before or do next takes at least 1 cycle to have effect
     {}
 
+    // The same delay, shrunk (or stretched) to a percentage of itself.
+    constexpr USI_TWI_Delay scaled(unsigned percent) const {
+      return USI_TWI_Delay(Cycles{}, cycles * percent / 100);
+    }
+
+    constexpr unsigned long in_cycles() const {
+      return cycles;
+    }
+
     inline void wait() const {
       __builtin_avr_delay_cycles(cycles);
     }
 };
 
+// A delay that can be changed while running, for tuning, at the expense of
+// precision: it waits in loops of 4 cycles, on top of the few cycles of loading
+// the count. It never waits less than the number of cycles set.
+class USI_TWI_Variable_Delay {
+    uint16_t loops = 0;
+
+  public:
+    void set(unsigned long cycles) {
+      unsigned long const l = (cycles + 3) / 4;
+      loops = l > 0xFFFF ? 0xFFFF : l;
+    }
+
+    unsigned long in_cycles() const {
+      return loops * 4ul;
+    }
+
+    inline void wait() const {
+      if (loops) {
+        _delay_loop_2(loops);
+      }
+    }
+};
+
 /* Device concept:
 struct Device {
   static constexpr uint8_t ADDRESS;
@@ -134,6 +171,8 @@ struct Device {
   static constexpr USI_TWI_Delay tPOST_SCL_HIGH;
   static constexpr USI_TWI_Delay tPOST_TRANSFER;
 };
+The delays may also be of any other type with a wait() method,
+such as USI_TWI_Variable_Delay.
 */
 
 void               USI_TWI_Master_Initialise();
@@ -162,4 +201,7 @@ USI_TWI_ErrorLevel USI_TWI_Master_Receive(unsigned char* buf, unsigned char len)
 template <typename Device>
 USI_TWI_ErrorLevel USI_TWI_Master_Stop();
 
+template <typename Device>
+USI_TWI_ErrorLevel USI_TWI_Master_Bus_Clear();
+
 #include "USI_TWI_Master.hpp"
@@ -177,3 +177,32 @@ USI_TWI_ErrorLevel USI_TWI_Master_Stop() {
 
   return USI_TWI_OK;
 }
+
+/*!
+ * @brief Function for recovering the bus after an error left a slave
+ * halfway a byte, holding SDA low. Clocks SCL until the slave releases SDA,
+ * then resets the USI and generates a Stop Condition.
+ * @return Returns USI_TWI_OK if the bus is free, otherwise returns error code.
+ */
+template <typename Device>
+USI_TWI_ErrorLevel USI_TWI_Master_Bus_Clear() {
+  USIDR = 0xFF;                   // Release SDA as far as the USI is concerned.
+  PORT_USI |= (1 << PIN_USI_SDA); // Release SDA.
+  for (unsigned char pulses = 0; pulses < 9; ++pulses) {
+    if (PIN_USI & (1 << PIN_USI_SDA)) {
+      break;
+    }
+    PORT_USI &= ~(1 << PIN_USI_SCL); // Pull SCL LOW.
+    Device::tPRE_SCL_HIGH.wait();
+    PORT_USI |= (1 << PIN_USI_SCL); // Release SCL.
+    Device::tPOST_SCL_HIGH.wait();
+  }
+  if (!(PIN_USI & (1 << PIN_USI_SDA))) {
+    return USI_TWI_UE_DATA_COL;
+  }
+
+  USI_TWI_Master_Initialise();
+  PORT_USI &= ~(1 << PIN_USI_SCL); // Pull SCL LOW, as a Stop Condition expects.
+  Device::tPRE_SCL_HIGH.wait();
+  return USI_TWI_Master_Stop<Device>();
+}
@@ -0,0 +1,48 @@
+#pragma once
+// Stand-in for the Arduino core, to compile parts of the sketch on a host.
+// Pins are the bits of port B, as on an ATtiny85, and time is the host's.
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef uint8_t byte;
+
+#define LED_BUILTIN 1
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  if (mode == OUTPUT) {
+    DDRB |= 1 << pin;
+  } else {
+    DDRB &= ~(1 << pin);
+  }
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  if (value) {
+    PORTB |= 1 << pin;
+  } else {
+    PORTB &= ~(1 << pin);
+  }
+}
+
+inline int digitalRead(uint8_t pin) {
+  return PINB >> pin & 1;
+}
+
+inline unsigned long micros() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (unsigned long)(now.tv_sec * 1000000ul + now.tv_nsec / 1000);
+}
+
+inline unsigned long millis() {
+  return micros() / 1000;
+}
+
+inline void delayMicroseconds(unsigned int) {}
+inline void delay(unsigned long) {}
@@ -0,0 +1,329 @@
+#pragma once
+// A model of what an SSD1306 or SH1106 makes of the bytes it receives over I2C,
+// for replaying the sketch's traffic on a host. It keeps the display RAM, checks
+// that each byte is something the controller accepts, and counts the bytes.
+// OLED::ModelDevice<Controller> is a Device whose bus goes into the model
+// instead of the USI, so that it can be passed to anything taking a Device.
+#include "../OLED.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+namespace OLED {
+
+template <typename Controller>
+class ControllerModel {
+  public:
+    static uint8_t constexpr ADDRESS = 0x3C;
+    static uint8_t constexpr RAM_COLUMNS = WIDTH + 2 * Controller::COLUMN_OFFSET;
+    static uint8_t constexpr PAGES = BYTES_PER_SEG;
+
+    uint8_t ram[PAGES][RAM_COLUMNS];
+
+    // Since the last reset_counts()
+    unsigned long bytes;        // including address bytes
+    unsigned long data_bytes;   // written to RAM
+    unsigned long transactions; // each from start to stop
+    unsigned long restarts;
+    unsigned long violations;
+    std::string first_violation;
+
+  private:
+    enum Phase { CONTROL, SINGLE, STREAM };
+
+    bool started = false;
+    bool addressed = false;
+    Phase phase = CONTROL;
+    bool data_mode = false;
+    uint8_t command[3];
+    uint8_t command_length = 0;
+    uint8_t command_size = 0;
+
+    // State after reset: page addressing, the whole display as window.
+    Addressing mode = PageAddressing;
+    uint8_t col_start = 0;
+    uint8_t col_end = WIDTH - 1;
+    uint8_t page_start = 0;
+    uint8_t page_end = PAGES - 1;
+    uint8_t col = 0;
+    uint8_t page = 0;
+
+    void violation(char const* format, ...) {
+      if (violations++ == 0) {
+        char message[100];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(message, sizeof message, format, args);
+        va_end(args);
+        first_violation = message;
+      }
+    }
+
+    // The size of a command including its arguments, or 0 if the controller doesn't know it.
+    static uint8_t size(uint8_t b) {
+      if (b == 0xAE || b == 0xAF || (b & 0xF8) == 0xB0 || b < 0x20) {
+        return 1;
+      }
+      if (b == 0x81 || b == Controller::CHARGE_PUMP) {
+        return 2;
+      }
+      if (Controller::WINDOWING) {
+        if (b == 0x20) {
+          return 2;
+        }
+        if (b == 0x21 || b == 0x22) {
+          return 3;
+        }
+      }
+      return 0;
+    }
+
+    bool in_page_mode() const {
+      return !Controller::WINDOWING || mode == PageAddressing;
+    }
+
+    void execute() {
+      uint8_t const b = command[0];
+      if (b == 0x20) {
+        if (command[1] > PageAddressing) {
+          violation("addressing mode %u", command[1]);
+        }
+        mode = Addressing(command[1]);
+      } else if (b == 0x21) {
+        if (command[1] > command[2] || command[2] >= WIDTH) {
+          violation("column window %u to %u", command[1], command[2]);
+        }
+        col = col_start = command[1];
+        col_end = command[2];
+      } else if (b == 0x22) {
+        if (command[1] > command[2] || command[2] >= PAGES) {
+          violation("page window %u to %u", command[1], command[2]);
+        }
+        page = page_start = command[1];
+        page_end = command[2];
+      } else if ((b & 0xF8) == 0xB0 || b < 0x20) {
+        if (!in_page_mode()) {
+          violation("positioning command 0x%02X outside page addressing", b);
+        }
+        if (b >= 0xB0) {
+          page = b & 0x07;
+        } else if (b < 0x10) {
+          col = (col & 0xF0) | (b & 0x0F);
+        } else {
+          col = (col & 0x0F) | (b & 0x0F) << 4;
+        }
+      } else if (b == Controller::CHARGE_PUMP) {
+        if (command[1] != Controller::CHARGE_PUMP_ON) {
+          violation("charge pump setting 0x%02X", command[1]);
+        }
+      }
+    }
+
+    void receive_command(uint8_t b) {
+      if (command_length == 0) {
+        command_size = size(b);
+        if (command_size == 0) {
+          violation("unknown command 0x%02X", b);
+          return;
+        }
+      }
+      command[command_length++] = b;
+      if (command_length == command_size) {
+        execute();
+        command_length = 0;
+      }
+    }
+
+    void receive_data(uint8_t b) {
+      if (command_length != 0) {
+        violation("data while command 0x%02X awaits arguments", command[0]);
+      }
+      if (!Controller::WINDOWING) {
+        // No wrapping: the column stops at the end of RAM.
+        if (col >= RAM_COLUMNS) {
+          violation("data past the end of page %u", page);
+          return;
+        }
+        ram[page][col++] = b;
+      } else {
+        ram[page][col] = b;
+        switch (mode) {
+          case HorizontalAddressing:
+            if (col++ == col_end) {
+              col = col_start;
+              page = page == page_end ? page_start : page + 1;
+            }
+            break;
+          case VerticalAddressing:
+            if (page++ == page_end) {
+              page = page_start;
+              col = col == col_end ? col_start : col + 1;
+            }
+            break;
+          case PageAddressing:
+            col = col == col_end ? col_start : col + 1;
+            break;
+        }
+      }
+      ++data_bytes;
+    }
+
+    void end_of_message(char const* why) {
+      if (command_length != 0) {
+        violation("command 0x%02X cut short by %s", command[0], why);
+        command_length = 0;
+      }
+    }
+
+  public:
+    ControllerModel() {
+      memset(ram, 0, sizeof ram);
+      reset_counts();
+    }
+
+    void reset_counts() {
+      bytes = data_bytes = transactions = restarts = violations = 0;
+      first_violation.clear();
+    }
+
+    // The byte shown at pixel column x of a page.
+    uint8_t shown(uint8_t p, uint8_t x) const {
+      return ram[p][Controller::COLUMN_OFFSET + x];
+    }
+
+    void start() {
+      if (started) {
+        end_of_message("a repeated start");
+        ++restarts;
+      }
+      started = true;
+      addressed = false;
+    }
+
+    // Returns whether the byte is acknowledged.
+    bool transmit(uint8_t b, bool isAddress) {
+      ++bytes;
+      if (!started) {
+        violation("byte 0x%02X outside a transaction", b);
+        return false;
+      }
+      if (isAddress) {
+        if (b >> 1 != ADDRESS) {
+          return false;
+        }
+        if (b & 1) {
+          violation("read from a controller that can't be read over I2C");
+        }
+        addressed = true;
+        phase = CONTROL;
+        return true;
+      }
+      if (!addressed) {
+        violation("byte 0x%02X before the address", b);
+        return false;
+      }
+      switch (phase) {
+        case CONTROL:
+          if (b & 0x3F) {
+            violation("control byte 0x%02X", b);
+          }
+          data_mode = b & PAYLOAD_DATA;
+          phase = b & PAYLOAD_COMMAND ? SINGLE : STREAM;
+          break;
+        case SINGLE:
+          phase = CONTROL;
+          // fall through
+        case STREAM:
+          if (data_mode) {
+            receive_data(b);
+          } else {
+            receive_command(b);
+          }
+          break;
+      }
+      return true;
+    }
+
+    void stop() {
+      if (!started) {
+        violation("stop outside a transaction");
+      }
+      end_of_message("a stop");
+      started = false;
+      addressed = false;
+      ++transactions;
+    }
+};
+
+template <typename Controller>
+ControllerModel<Controller>& model() {
+  static ControllerModel<Controller> m;
+  return m;
+}
+
+template <typename Controller_>
+struct ModelDevice {
+  using Controller = Controller_;
+  static constexpr uint8_t ADDRESS { ControllerModel<Controller>::ADDRESS };
+  static constexpr USI_TWI_Delay tHSTART { 0 };
+  static constexpr USI_TWI_Delay tSSTOP { 0 };
+  static constexpr USI_TWI_Delay tIDLE { 0 };
+  static constexpr USI_TWI_Delay tPRE_SCL_HIGH { 0 };
+  static constexpr USI_TWI_Delay tPOST_SCL_HIGH { 0 };
+  static constexpr USI_TWI_Delay tPOST_TRANSFER { 0 };
+};
+
+template <typename Controller>
+USI_TWI_ErrorLevel modelStart() {
+  model<Controller>().start();
+  return USI_TWI_OK;
+}
+
+template <typename Controller>
+USI_TWI_ErrorLevel modelTransmit(unsigned char msg, bool isAddress) {
+  if (model<Controller>().transmit(msg, isAddress)) {
+    return USI_TWI_OK;
+  }
+  return isAddress ? USI_TWI_NO_ACK_ON_ADDRESS : USI_TWI_NO_ACK_ON_DATA;
+}
+
+template <typename Controller>
+USI_TWI_ErrorLevel modelStop() {
+  model<Controller>().stop();
+  return USI_TWI_OK;
+}
+
+}
+
+template <>
+inline USI_TWI_ErrorLevel USI_TWI_Master_Start<OLED::ModelDevice<OLED::SSD1306>>() {
+  return OLED::modelStart<OLED::SSD1306>();
+}
+
+template <>
+inline USI_TWI_ErrorLevel USI_TWI_Master_Transmit<OLED::ModelDevice<OLED::SSD1306>>(unsigned char msg, bool isAddress) {
+  return OLED::modelTransmit<OLED::SSD1306>(msg, isAddress);
+}
+
+template <>
+inline USI_TWI_ErrorLevel USI_TWI_Master_Stop<OLED::ModelDevice<OLED::SSD1306>>() {
+  return OLED::modelStop<OLED::SSD1306>();
+}
+
+template <>
+inline USI_TWI_ErrorLevel USI_TWI_Master_Start<OLED::ModelDevice<OLED::SH1106>>() {
+  return OLED::modelStart<OLED::SH1106>();
+}
+
+template <>
+inline USI_TWI_ErrorLevel USI_TWI_Master_Transmit<OLED::ModelDevice<OLED::SH1106>>(unsigned char msg, bool isAddress) {
+  return OLED::modelTransmit<OLED::SH1106>(msg, isAddress);
+}
+
+template <>
+inline USI_TWI_ErrorLevel USI_TWI_Master_Stop<OLED::ModelDevice<OLED::SH1106>>() {
+  return OLED::modelStop<OLED::SH1106>();
+}
+
+void USI_TWI_Master_Initialise() {}
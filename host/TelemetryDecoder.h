@@ -0,0 +1,64 @@
+#pragma once
+#include "../TelemetryFormat.h"
+#include <string.h>
+
+namespace Telemetry {
+
+// Picks the records out of the telemetry stream, byte by byte. Bytes before
+// a SYNC are skipped. A record that turns out bad, with an unknown kind or
+// a wrong checksum, is counted and then searched again from the byte after
+// its SYNC. That way, a good record hiding behind junk, such as the tail of
+// a record cut short by a reset, is not lost.
+class Decoder {
+  private:
+    static unsigned constexpr LONGEST = OVERHEAD + 255;
+
+    uint8_t buf[LONGEST];
+    unsigned got = 0; // bytes in buf, starting with SYNC unless empty
+
+    void drop(unsigned n) {
+      memmove(buf, buf + n, got - n);
+      got -= n;
+    }
+
+  public:
+    unsigned bad_records = 0;
+
+    // Take in one byte, and call found(kind, payload) for each record it completes.
+    template <typename Found>
+    void put(uint8_t c, Found found) {
+      buf[got++] = c;
+      while (got > 0) {
+        if (buf[0] != SYNC) {
+          drop(1);
+          continue;
+        }
+        if (got < 2) {
+          return;
+        }
+        uint8_t const size = payloadSize(buf[1]);
+        if (size == 0) {
+          ++bad_records;
+          drop(1);
+          continue;
+        }
+        unsigned const length = OVERHEAD + size;
+        if (got < length) {
+          return;
+        }
+        uint8_t sum = 0;
+        for (unsigned i = 1; i < length; ++i) {
+          sum += buf[i];
+        }
+        if (sum != 0) {
+          ++bad_records;
+          drop(1);
+          continue;
+        }
+        found(buf[1], static_cast<uint8_t const*>(&buf[2]));
+        drop(length);
+      }
+    }
+};
+
+}
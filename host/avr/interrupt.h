@@ -0,0 +1,6 @@
+#pragma once
+// Stand-in for avr-libc's: an interrupt routine is a function to call.
+#define ISR(vector) void vector()
+
+inline void cli() {}
+inline void sei() {}
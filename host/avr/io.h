@@ -0,0 +1,37 @@
+#pragma once
+// Stand-in for avr-libc's, for the ATtiny85 registers the sketch touches.
+// Registers are plain variables, defined here because each host program
+// is a single translation unit. Nothing happens when they are written.
+#include <stdint.h>
+
+volatile uint8_t PORTB, DDRB, PINB;
+volatile uint8_t USIDR, USISR, USICR;
+volatile uint8_t TCCR1, GTCCR, OCR1A, OCR1C, TCNT1, TIMSK, TIFR;
+
+enum {
+  PB0, PB1, PB2, PB3, PB4, PB5,
+};
+enum {
+  PORTB0, PORTB1, PORTB2, PORTB3, PORTB4, PORTB5,
+};
+enum {
+  PINB0, PINB1, PINB2, PINB3, PINB4, PINB5,
+};
+enum {
+  USICNT0, USICNT1, USICNT2, USICNT3, USIDC, USIPF, USIOIF, USISIF,
+};
+enum {
+  USITC, USICLK, USICS0, USICS1, USIWM0, USIWM1, USIOIE, USISIE,
+};
+enum {
+  CS10, CS11, CS12, CS13, COM1A0, COM1A1, PWM1A, CTC1,
+};
+enum {
+  PSR0, PSR1,
+};
+enum {
+  TOIE0 = 1, TOIE1, OCIE0B, OCIE0A, OCIE1B, OCIE1A,
+};
+enum {
+  TOV0 = 1, TOV1, OCF0B, OCF0A, OCF1B, OCF1A,
+};
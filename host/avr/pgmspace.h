@@ -0,0 +1,4 @@
+#pragma once
+// Stand-in for avr-libc's, to compile the sketch's PROGMEM tables on a host.
+#define PROGMEM
+#define pgm_read_byte(p) (*(const unsigned char*)(p))
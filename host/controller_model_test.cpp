@@ -0,0 +1,155 @@
+// Replays each way RoomFlush.h gets the room across, for an SSD1306 and an
+// SH1106, into the controller model of ControllerModel.h. Checks that every
+// byte is one the controller accepts, that the display ends up showing what
+// was composed, and prints how many bus bytes each way takes.
+//
+// Build: g++ -O2 -std=c++11 -D__AVR_ATtiny85__ -DF_CPU=8000000UL -I. -I.. -o controller_model_test controller_model_test.cpp
+#include "ControllerModel.h"
+#include "../RoomFlush.h"
+
+// Display bytes that differ per pixel column, page and pass, so that any
+// byte ending up in the wrong place, or not being sent, shows.
+struct Pattern {
+  static uint8_t pass;
+
+  static uint8_t at(uint8_t x, uint8_t page) {
+    return uint8_t(x * 7 + page * 31 + pass * 101);
+  }
+
+  static void cells(uint8_t c, uint8_t rp, uint8_t* out, uint8_t stride) {
+    for (uint8_t i = 0; i < X_PER_COL; ++i) {
+      out[i * stride] = at(c * X_PER_COL + i, rp);
+    }
+  }
+};
+
+uint8_t Pattern::pass = 0;
+
+static unsigned failures = 0;
+
+template <typename Controller>
+class Replay {
+    using Device = OLED::ModelDevice<Controller>;
+    using Flush = RoomFlush<Device, Pattern>;
+    using Model = OLED::ControllerModel<Controller>;
+
+    char const* const name;
+    Model& m = OLED::model<Controller>();
+    uint8_t shown[OLED::BYTES_PER_SEG][OLED::WIDTH]; // what should be shown
+
+    void fail(char const* what) {
+      printf("%s: %s\n", name, what);
+      ++failures;
+    }
+
+    // Start counting a new replay with a new pattern.
+    void begin() {
+      m.reset_counts();
+      ++Pattern::pass;
+    }
+
+    void expect(uint8_t xBegin, uint8_t xEnd, uint8_t pBegin, uint8_t pEnd) {
+      for (uint8_t p = pBegin; p <= pEnd; ++p) {
+        for (uint8_t x = xBegin; x <= xEnd; ++x) {
+          shown[p][x] = Pattern::at(x, p);
+        }
+      }
+    }
+
+    // Check the replay was legal and left the display as expected, and print its bytes.
+    void end(char const* what, I2C::Status status = I2C::Status { 0, 0 }) {
+      if (status.error) {
+        printf("%s: %s failed with error %u at %u\n", name, what, status.error, status.location);
+        ++failures;
+      }
+      if (m.violations) {
+        printf("%s: %s broke the rules %lu times, first: %s\n", name, what, m.violations, m.first_violation.c_str());
+        ++failures;
+      }
+      unsigned wrong = 0;
+      for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+        for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+          wrong += m.shown(p, x) != shown[p][x];
+        }
+      }
+      if (wrong) {
+        printf("%s: %s left %u display bytes wrong\n", name, what, wrong);
+        ++failures;
+      }
+      printf("%s,%s,%lu,%lu,%lu,%lu\n", name, what, m.bytes, m.data_bytes, m.transactions, m.restarts);
+    }
+
+    void init() {
+      begin();
+      end("init", Flush::prepare(OLED::Chat<Device>(0).init()).set_enabled().stop());
+    }
+
+    void frame() {
+      begin();
+      uint8_t step = 0;
+      auto const status = Flush::display(step);
+      expect(0, OLED::WIDTH - 1, 0, OLED::BYTES_PER_SEG - 1);
+      if (step != Flush::STEPS) {
+        fail("frame stopped early");
+      }
+      end("frame", status);
+    }
+
+    // The rest of a frame interrupted halfway, which must leave the first half alone.
+    void resume() {
+      begin();
+      uint8_t step = Flush::STEPS / 2;
+      auto const status = Flush::display(step);
+      if (Controller::WINDOWING) {
+        expect(Flush::STEPS / 2 * X_PER_COL, OLED::WIDTH - 1, 0, OLED::BYTES_PER_SEG - 1);
+      } else {
+        expect(0, OLED::WIDTH - 1, Flush::STEPS / 2, OLED::BYTES_PER_SEG - 1);
+      }
+      end("resume", status);
+    }
+
+    // Regions in one session, as the region scheduler sends them.
+    void regions() {
+      struct Area {
+        uint8_t xBegin, xEnd, pBegin, pEnd;
+      };
+      static Area const areas[] = {
+        { 8, 11, 3, 3 },                                     // a cell whose wall was knocked down
+        { 20, 27, 4, 5 },                                    // the ball, straddling pages
+        { X_PER_COL, 2 * X_PER_COL - 1, 0, 1 },              // the heartbeat
+        { X_PER_COL, 10 * X_PER_COL - 1, 0, 1 },             // the status, on the same pages
+        { OLED::WIDTH - X_PER_COL, OLED::WIDTH - 1, 7, 7 },  // the last cell
+      };
+      begin();
+      OLED::Session<Device> session(20);
+      for (Area const& a : areas) {
+        if (!Flush::region(session, a.xBegin, a.xEnd, a.pBegin, a.pEnd)) {
+          fail("region not acknowledged");
+        }
+        expect(a.xBegin, a.xEnd, a.pBegin, a.pEnd);
+      }
+      end("regions", session.stop());
+    }
+
+  public:
+    explicit Replay(char const* name) : name(name) {
+      memset(shown, 0, sizeof shown);
+    }
+
+    void run() {
+      init();
+      frame();
+      resume();
+      regions();
+      // A full frame after regions left a window of their own.
+      frame();
+    }
+};
+
+int main() {
+  puts("controller,replay,bus bytes,data bytes,transactions,restarts");
+  Replay<OLED::SSD1306>("SSD1306").run();
+  Replay<OLED::SH1106>("SH1106").run();
+  printf("%u failures\n", failures);
+  return failures == 0 ? 0 : 1;
+}
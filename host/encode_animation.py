@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Encode 128x64 PBM images into a PROGMEM animation stream for Animation.h.
+
+The first image is encoded in full, every next one as the difference from
+the previous. Either way, a frame is a series of spans, each covering a range
+of display columns across all pages, in the column order of vertical
+addressing, followed by END_OF_FRAME. A span is
+    x_begin, x_end, run-length coded bytes
+where each run is a token n followed by:
+    n < 0x80: n + 1 literal bytes,
+    n >= 0x80: one byte to be repeated n - 0x80 + 1 times.
+Changed columns separated by only a few unchanged ones are covered by a single
+span, whenever resending the unchanged ones is cheaper than a new window.
+
+    host/encode_animation.py NAME frame0.pbm frame1.pbm ... > NAME.h
+"""
+import sys
+
+WIDTH = 128
+HEIGHT = 64
+PAGES = HEIGHT // 8
+END_OF_FRAME = 0xFF
+# All spans of a frame go in a single session. Bus bytes spent on a span: the
+# address after the (repeated) start, 3 column window command bytes with their
+# prefixes, and the data prefix. The page window is the same for every span,
+# so it's only sent with the first, costing 3 command bytes with their prefixes.
+WINDOW_COST = 1 + 2 * 3 + 1
+PAGE_WINDOW_COST = 2 * 3
+
+
+def read_pbm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    magic, width, height = fields[0], int(fields[1]), int(fields[2])
+    if (width, height) != (WIDTH, HEIGHT):
+        sys.exit("%s: %dx%d instead of %dx%d" % (path, width, height, WIDTH, HEIGHT))
+    if magic == b"P4":
+        raster = data[pos + 1:]
+        stride = (WIDTH + 7) // 8
+        pixel = lambda x, y: raster[y * stride + x // 8] >> (7 - x % 8) & 1
+    elif magic == b"P1":
+        bits = [c - ord("0") for c in data[pos:] if c in b"01"]
+        pixel = lambda x, y: bits[y * WIDTH + x]
+    else:
+        sys.exit("%s: not a PBM file" % path)
+    # One list of PAGES display bytes per column, bit 0 being the top pixel.
+    return [[sum(pixel(x, page * 8 + bit) << bit for bit in range(8))
+             for page in range(PAGES)]
+            for x in range(WIDTH)]
+
+
+def run_length(data):
+    out = []
+    i = 0
+    literal = []
+
+    def flush():
+        while literal:
+            chunk = literal[:0x80]
+            del literal[:0x80]
+            out.extend([len(chunk) - 1] + chunk)
+
+    while i < len(data):
+        n = 1
+        while i + n < len(data) and data[i + n] == data[i] and n < 0x80:
+            n += 1
+        if n >= 3:
+            flush()
+            out.extend([0x80 + n - 1, data[i]])
+        else:
+            literal.extend(data[i:i + n])
+        i += n
+    flush()
+    return out
+
+
+def spans(previous, current):
+    changed = [x for x in range(WIDTH) if previous is None or previous[x] != current[x]]
+    result = []
+    for x in changed:
+        if result and (x - result[-1][1] - 1) * PAGES < WINDOW_COST:
+            result[-1][1] = x
+        else:
+            result.append([x, x])
+    return result
+
+
+def encode_frame(previous, current):
+    out = []
+    bus_bytes = PAGE_WINDOW_COST
+    for x_begin, x_end in spans(previous, current):
+        data = [b for x in range(x_begin, x_end + 1) for b in current[x]]
+        out.extend([x_begin, x_end] + run_length(data))
+        bus_bytes += WINDOW_COST + len(data)
+    out.append(END_OF_FRAME)
+    return out, bus_bytes
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    name = sys.argv[1]
+    frames = [read_pbm(path) for path in sys.argv[2:]]
+    stream = []
+    report = []
+    previous = None
+    for index, frame in enumerate(frames):
+        encoded, bus_bytes = encode_frame(previous, frame)
+        report.append("frame %d: %d bytes encoded, %d bytes on the bus"
+                      % (index, len(encoded), bus_bytes))
+        stream.extend(encoded)
+        previous = frame
+    raw = len(frames) * WIDTH * PAGES
+    report.append("%d bytes instead of %d, compression ratio %.1f"
+                  % (len(stream), raw, raw / len(stream)))
+    for line in report:
+        print(line, file=sys.stderr)
+
+    print("#pragma once")
+    print("// Generated by host/encode_animation.py from %s." % " ".join(sys.argv[2:]))
+    for line in report:
+        print("// " + line)
+    print("#include <Arduino.h>")
+    print()
+    print("static uint8_t constexpr %s_FRAMES = %d;" % (name.upper(), len(frames)))
+    print("static uint8_t const %s[] PROGMEM = {" % name)
+    for i in range(0, len(stream), 16):
+        print("  " + " ".join("0x%02X," % b for b in stream[i:i + 16]))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
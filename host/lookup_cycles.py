@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Cycles per wall lookup on an ATtiny85, counted from the compiler's output.
+
+Compiles getWall() and the lookup of WallMap, from Room.h, each into a function
+of its own, and adds up the cycles of their instructions along the slowest path,
+as the AVR instruction set manual gives them for an ATtiny85. The return isn't
+counted, since the sketch inlines lookups. Fails if looking up the wall map is
+slower than getWall(), which the wall map is meant to never be.
+
+Compile with avr-g++ as the Arduino IDE does, or with $CXX and $CXXFLAGS:
+    host/lookup_cycles.py
+Or count an assembly listing produced otherwise, such as by LLVM from the same
+functions in host/wall_lookups.ll:
+    llc -O2 -mtriple=avr -mcpu=attiny85 -o - host/wall_lookups.ll | host/lookup_cycles.py -
+"""
+import os
+import re
+import subprocess
+import sys
+
+FUNCTIONS = ("progmemLookup", "mapLookup")
+
+SOURCE = """
+#include "Room.h"
+WallMap walls;
+extern "C" bool progmemLookup(uint8_t row, uint8_t col) { return getWall(row, col); }
+extern "C" bool mapLookup(uint8_t row, uint8_t col) { return walls(row, col); }
+"""
+
+# Cycles taken on an ATtiny85, apart from branches and skips.
+CYCLES = {}
+for mnemonic in ("add adc sub subi sbc sbci and andi or ori eor com neg sbr cbr inc dec tst clr ser "
+                 "cp cpc cpi mov movw ldi lsl lsr rol ror asr swap bst bld in out nop "
+                 "sec clc sen cln sez clz sei cli ses cls sev clv set clt seh clh").split():
+    CYCLES[mnemonic] = 1
+for mnemonic in "adiw sbiw ld ldd lds st std sts push pop sbi cbi".split():
+    CYCLES[mnemonic] = 2
+for mnemonic in "lpm rcall icall".split():
+    CYCLES[mnemonic] = 3
+CYCLES["rjmp"] = 2
+CYCLES["ijmp"] = 2
+SKIPS = {"sbrc", "sbrs", "sbic", "sbis", "cpse"}
+TWO_WORDS = {"lds", "sts", "jmp", "call"}
+RETURNS = {"ret", "reti"}
+
+INSTRUCTION = re.compile(r"^\s+([a-z]+)\s*(.*?)\s*(?:;.*)?$")
+LABEL = re.compile(r"^([.\w$]+):")
+
+
+def compile_source():
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+    cxx = os.environ.get("CXX", "avr-g++")
+    flags = os.environ.get("CXXFLAGS", "-Os -mmcu=attiny85 -std=gnu++11").split()
+    return subprocess.run([cxx] + flags + ["-I", root, "-x", "c++", "-S", "-o", "-", "-"],
+                          input=SOURCE, capture_output=True, text=True, check=True).stdout
+
+
+def function_body(listing, name):
+    """The instructions of a function, and where its labels are among them."""
+    lines = iter(listing.splitlines())
+    for line in lines:
+        if line.startswith(name + ":"):
+            break
+    else:
+        sys.exit("%s not found" % name)
+    instructions = []
+    labels = {}
+    for line in lines:
+        line = re.sub(r"/\*.*?\*/", "", line)
+        if re.match(r"\s*\.size\s+%s\b" % re.escape(name), line):
+            break
+        label = LABEL.match(line)
+        if label:
+            labels[label.group(1)] = len(instructions)
+            continue
+        match = INSTRUCTION.match(line)
+        if match and not match.group(1).startswith("."):
+            instructions.append((match.group(1), match.group(2)))
+    return instructions, labels
+
+
+def target(instructions, labels, index, operand):
+    """The index of the instruction a branch from index goes to."""
+    if operand in labels:
+        return labels[operand]
+    relative = re.match(r"^\.([+-]\d+)$", operand)
+    if not relative:
+        sys.exit("can't follow a branch to %s" % operand)
+    # Relative to the next instruction, in bytes.
+    offset = int(relative.group(1))
+    i = index + 1
+    while offset > 0:
+        offset -= 4 if instructions[i][0] in TWO_WORDS else 2
+        i += 1
+    while offset < 0:
+        i -= 1
+        offset += 4 if instructions[i][0] in TWO_WORDS else 2
+    return i
+
+
+def slowest(instructions, labels):
+    """Cycles along the slowest path through straight code and forward branches."""
+    memo = {}
+
+    def cycles(i, visiting):
+        if i >= len(instructions):
+            return 0
+        if i in memo:
+            return memo[i]
+        if i in visiting:
+            sys.exit("a loop, whose cycles depend on how often it runs")
+        visiting = visiting | {i}
+        mnemonic, operands = instructions[i]
+        if mnemonic in RETURNS:
+            result = 0
+        elif mnemonic.startswith("br"):
+            result = max(1 + cycles(i + 1, visiting),
+                         2 + cycles(target(instructions, labels, i, operands), visiting))
+        elif mnemonic in ("rjmp", "jmp"):
+            result = CYCLES.get(mnemonic, 3) + cycles(target(instructions, labels, i, operands), visiting)
+        elif mnemonic in SKIPS:
+            skipped = 3 if i + 1 < len(instructions) and instructions[i + 1][0] in TWO_WORDS else 2
+            result = max(1 + cycles(i + 1, visiting), skipped + cycles(i + 2, visiting))
+        elif mnemonic in CYCLES:
+            result = CYCLES[mnemonic] + cycles(i + 1, visiting)
+        else:
+            sys.exit("no cycle count for %s" % mnemonic)
+        memo[i] = result
+        return result
+
+    return cycles(0, frozenset())
+
+
+def main():
+    if len(sys.argv) > 1:
+        path = sys.argv[1]
+        listing = sys.stdin.read() if path == "-" else open(path).read()
+    else:
+        listing = compile_source()
+    counts = {}
+    for name in FUNCTIONS:
+        instructions, labels = function_body(listing, name)
+        counts[name] = slowest(instructions, labels)
+        print("%s: %d cycles, %d instructions" % (name, counts[name], len(instructions)))
+    if counts["mapLookup"] > counts["progmemLookup"]:
+        sys.exit("looking up the wall map is slower than getWall()")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+// Checks that Overlay.h composes the same bytes in whatever order the room is
+// flushed: in windowed order, where each cell column is asked for again for
+// every page, in page order, and one column at a time from scratch, over a few
+// frames of the heartbeat. The bytes expected are those GlyphsOnQuarter sends
+// for the same glyphs, replayed into the controller model of ControllerModel.h.
+//
+// Build: g++ -O2 -std=c++11 -D__AVR_ATtiny85__ -DF_CPU=8000000UL -I. -I.. -o overlay_test overlay_test.cpp
+#include "ControllerModel.h"
+#include "../Glyph.cpp"
+#include "../GlyphsOnQuarter.h"
+#include "../Overlay.h"
+#include "../Room.h"
+#include <functional>
+
+using Device = OLED::ModelDevice<OLED::SSD1306>;
+
+static unsigned failures = 0;
+static unsigned long composed = 0;
+
+// What's displayed underneath, showing through transparent overlays.
+static byte background(uint8_t p, uint8_t x) {
+  return byte(x * 13 + p * 57);
+}
+
+// A line of glyphs, as an overlay and as GlyphsOnQuarter sends it.
+struct Line {
+  char const* name;
+  OLED::Quarter quarter;
+  uint8_t xBegin;
+  bool opaque;
+  bool include_heartbeat;
+
+  Overlay overlay() const {
+    Overlay o { quarter, xBegin, Overlay::OVER_BALL, opaque, include_heartbeat };
+    o.put(3).put(GlyphPair::err).put3dec(11).put(3).put(Glyph::at).put3dec(57);
+    return o;
+  }
+
+  void send(bool heartbeat) const {
+    GlyphsOnQuarter<Device> chat { 0, quarter, xBegin, OLED::WIDTH - 1, heartbeat };
+    chat.send(0, 3);
+    chat.send(GlyphPair::err.left);
+    chat.send(GlyphPair::err.right);
+    chat.send3dec(11);
+    chat.send(0, 3);
+    chat.send(Glyph::at);
+    chat.send3dec(57);
+    chat.stop();
+  }
+};
+
+// Each display byte expected, without and with the heartbeat.
+static byte expected[2][OLED::BYTES_PER_SEG][OLED::WIDTH];
+
+static void expect(Line const& line) {
+  auto& m = OLED::model<OLED::SSD1306>();
+  uint8_t const page = static_cast<uint8_t>(line.quarter) * 2;
+  for (uint8_t heartbeat = 0; heartbeat < 2; ++heartbeat) {
+    memset(m.ram, 0, sizeof m.ram);
+    m.reset_counts();
+    line.send(heartbeat);
+    uint8_t const xEnd = line.xBegin + m.data_bytes / 2;
+    for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+      for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+        bool const covered = uint8_t(p - page) < 2 && x >= line.xBegin && x < xEnd;
+        byte const b = background(p, x);
+        // Where the overlay doesn't reach, the background shows through.
+        expected[heartbeat][p][x] = !covered ? b : line.opaque ? m.shown(p, x) : b | m.shown(p, x);
+      }
+    }
+  }
+}
+
+static void check(Line const& line, char const* order, unsigned frame, bool heartbeat,
+                  uint8_t p, uint8_t x, byte b) {
+  ++composed;
+  if (b != expected[heartbeat][p][x]) {
+    printf("%s: %s order, frame %u, page %u, column %u: 0x%02X instead of 0x%02X\n",
+           line.name, order, frame, p, x, b, expected[heartbeat][p][x]);
+    ++failures;
+  }
+}
+
+// Compose all frames in one order, as the room flush would.
+template <typename Order>
+static void compose(Line const& line, char const* name, Order order) {
+  Overlay o = line.overlay();
+  bool heartbeat = false;
+  for (unsigned frame = 0; frame < 3; ++frame) {
+    o.next_frame();
+    heartbeat = line.include_heartbeat && !heartbeat;
+    order([&](uint8_t p, uint8_t x) {
+      check(line, name, frame, heartbeat, p, x, o.compose(p, x, background(p, x)));
+    });
+  }
+}
+
+static void run(Line const& line) {
+  Overlay const fresh = line.overlay();
+  expect(line);
+
+  // As RoomFlush does with windowing: each cell column page after page.
+  compose(line, "windowed", [](std::function<void(uint8_t, uint8_t)> const& at) {
+    for (uint8_t c = 0; c < COLS; ++c) {
+      for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+        for (uint8_t i = 0; i < X_PER_COL; ++i) {
+          at(p, c * X_PER_COL + i);
+        }
+      }
+    }
+  });
+  // As RoomFlush does without windowing: each page across all columns.
+  compose(line, "page", [](std::function<void(uint8_t, uint8_t)> const& at) {
+    for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+      for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+        at(p, x);
+      }
+    }
+  });
+  // Every column from scratch, so the cursor only ever walks forward from the start.
+  bool heartbeat = false;
+  for (unsigned frame = 0; frame < 3; ++frame) {
+    heartbeat = line.include_heartbeat && !heartbeat;
+    for (uint8_t p = 0; p < OLED::BYTES_PER_SEG; ++p) {
+      for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+        Overlay o = fresh;
+        for (unsigned f = 0; f <= frame; ++f) {
+          o.next_frame();
+        }
+        check(line, "scratch", frame, heartbeat, p, x, o.compose(p, x, background(p, x)));
+      }
+    }
+  }
+
+  // Every column after every other, so that the cursor steps back by every
+  // distance, starts over from every distance, and on either side of where
+  // one becomes cheaper than the other, including back to the heartbeat.
+  Overlay beating = fresh;
+  beating.next_frame();
+  uint8_t const page = static_cast<uint8_t>(line.quarter) * 2;
+  for (uint8_t p = page; p < page + 2; ++p) {
+    for (uint8_t from = 0; from < OLED::WIDTH; ++from) {
+      for (uint8_t to = 0; to < OLED::WIDTH; ++to) {
+        Overlay o = beating;
+        o.compose(p, from, background(p, from));
+        check(line, "pairwise", 0, line.include_heartbeat, p, to, o.compose(p, to, background(p, to)));
+      }
+    }
+  }
+
+  // The heartbeat is on the first column only, and beats every frame.
+  if (line.include_heartbeat) {
+    for (uint8_t p = page; p < page + 2; ++p) {
+      for (uint8_t x = 0; x < OLED::WIDTH; ++x) {
+        if ((expected[0][p][x] != expected[1][p][x]) != (x == line.xBegin)) {
+          printf("%s: heartbeat %s column %u of page %u\n", line.name,
+                 x == line.xBegin ? "missing from" : "found in", x, p);
+          ++failures;
+        }
+      }
+    }
+  }
+}
+
+int main() {
+  // GlyphsOnQuarter sends both pages column after column, as the room does.
+  OLED::Chat<Device>(0).set_addressing_mode(OLED::VerticalAddressing).stop();
+  static Line const lines[] = {
+    { "error", OLED::Quarter::D, 0, true, true },
+    { "status", OLED::Quarter::A, X_PER_COL, true, true },
+    { "transparent", OLED::Quarter::B, 2 * X_PER_COL + 1, false, false },
+  };
+  for (Line const& line : lines) {
+    run(line);
+  }
+  printf("%lu bytes composed, %u failures\n", composed, failures);
+  return failures == 0 ? 0 : 1;
+}
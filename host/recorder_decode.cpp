@@ -0,0 +1,59 @@
+// Decodes a dump of the flight recorder's EEPROM into CSV lines, oldest first.
+//
+// Build: g++ -O2 -o recorder_decode recorder_decode.cpp
+// Use:   avrdude -p t85 -c usbtiny -U eeprom:r:eeprom.bin:r && ./recorder_decode eeprom.bin
+#include "../RecorderFormat.h"
+#include <stdio.h>
+
+using namespace Recorder;
+
+static unsigned u16(uint8_t const* p) {
+  return p[0] | p[1] << 8;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s eeprom.bin\n", argv[0]);
+    return 2;
+  }
+  FILE* f = fopen(argv[1], "rb");
+  if (!f) {
+    perror(argv[1]);
+    return 1;
+  }
+  Record slots[SLOTS];
+  size_t const count = fread(slots, sizeof(Record), SLOTS, f);
+  fclose(f);
+  if (count != SLOTS) {
+    fprintf(stderr, "%s: expected %u bytes\n", argv[1], EEPROM_BYTES);
+    return 1;
+  }
+
+  // The oldest record follows the most recent one, found where the sequence breaks.
+  unsigned head = 0;
+  for (unsigned i = 0; i < SLOTS; ++i) {
+    if (slots[i].kind == ERASED || (i > 0 && slots[i].seq != uint8_t(slots[i - 1].seq + 1))) {
+      head = i;
+      break;
+    }
+  }
+
+  puts("seq,kind,a,b,c,d,e,f");
+  for (unsigned n = 0; n < SLOTS; ++n) {
+    Record const& r = slots[(head + n) % SLOTS];
+    uint8_t const* p = r.payload;
+    switch (r.kind) {
+      case FAULT:
+        printf("%u,fault,%u,%u,%u,%u,%d,%d\n", r.seq, p[0], p[1], p[2], p[3], int8_t(p[4]), int8_t(p[5]));
+        break;
+      case RATE:
+        printf("%u,rate,%u,%u,%u,,,\n", r.seq, u16(p), u16(p + 2), u16(p + 4));
+        break;
+      case ERASED:
+        break;
+      default:
+        printf("%u,unknown %u,,,,,,\n", r.seq, r.kind);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+// Runs RegionScheduler.h with the regions the sketch defines, on a fake clock
+// crossing the wrap of its 16-bit milliseconds, with a flush that counts the
+// bus bytes each region is estimated to cost. Checks that the regions fitting
+// the budget of a frame never exceed it, that the whole room, which never fits,
+// still goes out after PATIENCE frames, and that the heartbeat and status keep
+// up with their rates. Prints the rates achieved, as reported.
+//
+// Build: g++ -O2 -std=c++11 -D__AVR_ATtiny85__ -DF_CPU=8000000UL -I. -I.. -o region_scheduler_test region_scheduler_test.cpp
+#include "../OLED.h"
+#include "../RegionScheduler.h"
+#include <stdio.h>
+
+using Scheduler = RegionScheduler<4>;
+
+static uint16_t constexpr BUDGET = 128;  // BUS_BYTES_PER_FRAME in the sketch
+static unsigned constexpr FRAME_MS = 23; // not dividing any period, so rates round
+static unsigned constexpr FRAMES = 100000 / FRAME_MS;
+static unsigned constexpr REPORT_FRAMES = 20000 / FRAME_MS;
+
+static unsigned failures = 0;
+
+static void fail(unsigned frame, char const* what) {
+  printf("frame %u: %s\n", frame, what);
+  ++failures;
+}
+
+int main() {
+  Scheduler regions;
+  // As addRegions() in the sketch, with the ball region covering two cells
+  // across two pages, as it does when the ball straddles them.
+  static char const* const names[] = { "ball", "heartbeat", "status", "room" };
+  uint8_t const ball = regions.add(24, 31, 2, 3, 0, 0);
+  regions.add(4, 7, 0, 1, 500, 1);   // heartbeat
+  regions.add(4, 39, 0, 1, 1000, 2); // status
+  uint8_t const room = regions.add(0, OLED::WIDTH - 1, 0, OLED::BYTES_PER_SEG - 1, 10000, 3);
+  if (regions[room].cost() != 1038) {
+    fail(0, "the whole room isn't estimated at what a frame costs");
+  }
+
+  // The longest each region may wait between refreshes: a period rounded up to
+  // whole frames, plus a frame when the status coincides with the heartbeat,
+  // or PATIENCE frames for the whole room.
+  unsigned const longest_ms[] = {
+    FRAME_MS,
+    500 + 2 * FRAME_MS,
+    1000 + 2 * FRAME_MS,
+    10000 + (Scheduler::PATIENCE + 1) * FRAME_MS,
+  };
+  unsigned long flushed_ms[4];
+  bool flushed_before[4] = {};
+
+  puts("region,period ms,refreshes,elapsed ms,most skipped");
+  unsigned long now_ms = 0;
+  unsigned frames_since_report = 0;
+  for (unsigned frame = 0; frame < FRAMES; ++frame, now_ms += FRAME_MS) {
+    // What the budget was spent on, apart from regions forced by patience.
+    uint16_t budgeted = 0;
+    regions.run(now_ms, BUDGET, [&](Scheduler::Region const & r) {
+      uint8_t index = 0;
+      while (&r != &regions[index]) {
+        ++index;
+      }
+      if (index == room) {
+        if (r.skipped != Scheduler::PATIENCE) {
+          fail(frame, "the whole room went out before running out of patience");
+        }
+      } else if (r.skipped >= Scheduler::PATIENCE) {
+        fail(frame, "a region that fits ran out of patience");
+      } else {
+        budgeted += r.cost();
+      }
+      if (flushed_before[index]) {
+        unsigned long const interval_ms = now_ms - flushed_ms[index];
+        if (interval_ms < r.period_ms || interval_ms > longest_ms[index]) {
+          printf("frame %u: %s refreshed after %lu ms\n", frame, names[index], interval_ms);
+          ++failures;
+        }
+      }
+      flushed_before[index] = true;
+      flushed_ms[index] = now_ms;
+      return true;
+    });
+    if (budgeted > BUDGET) {
+      fail(frame, "over budget");
+    }
+
+    if (++frames_since_report == REPORT_FRAMES) {
+      frames_since_report = 0;
+      for (uint8_t index = 0; index < regions.size(); ++index) {
+        regions.report(index, now_ms, [&](uint16_t period_ms, uint16_t refreshes, uint16_t elapsed_ms,
+        uint8_t most_skipped) {
+          printf("%s,%u,%u,%u,%u\n", names[index], period_ms, refreshes, elapsed_ms, most_skipped);
+          // Every period, give or take the refresh straddling the report.
+          unsigned const fewest = elapsed_ms / longest_ms[index];
+          unsigned const most = period_ms ? elapsed_ms / period_ms + 1 : elapsed_ms / FRAME_MS + 1;
+          if (unsigned(refreshes) + 1 < fewest || refreshes > most) {
+            fail(frame, "reported refreshes don't match the rate");
+          }
+          if (index == ball && refreshes != REPORT_FRAMES) {
+            fail(frame, "the ball region missed frames");
+          }
+          if (index == room && most_skipped != Scheduler::PATIENCE) {
+            fail(frame, "the whole room didn't wait for PATIENCE frames");
+          }
+        });
+      }
+    }
+  }
+  printf("%u frames, %u failures\n", FRAMES, failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+// Sweeps the state space of the ball in Room.h: every start position where
+// the ball fits and every pair of directions, spread over all cores.
+// For each start, follows the ball until it repeats a state, i.e. has entered
+// a periodic orbit, or gets trapped between walls. Along the way, counts the
+// bus bytes of each way of flushing, for each controller, by replaying
+// RoomFlush.h into the controller model. Prints a JSON report to diff between
+// releases.
+//
+// Build: g++ -O2 -std=c++11 -pthread -D__AVR_ATtiny85__ -DF_CPU=8000000UL -I. -I.. -o room_sweep room_sweep.cpp
+#include "ControllerModel.h"
+#include "../Room.h"
+#include "../RoomFlush.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static int8_t const Y_DIRS[] = { -2, -1, +1, +2 };
+static int8_t const X_DIRS[] = { -2, -1, +1, +2 };
+
+// Bus bytes don't depend on what's displayed, so compose nothing.
+struct Blank {
+  static void cells(uint8_t, uint8_t, uint8_t* out, uint8_t stride) {
+    for (uint8_t i = 0; i < X_PER_COL; ++i) {
+      out[i * stride] = 0;
+    }
+  }
+};
+
+// How the sketch flushes: the whole room every frame, or, with REFRESH_REGIONS,
+// at least the region covering the ball where it was last shown and where it is now.
+enum Strategy { FULL, BALL_REGION, STRATEGIES };
+static char const* const STRATEGY_NAMES[STRATEGIES] = { "full", "ball_region" };
+enum Panel { SSD1306, SH1106, PANELS };
+static char const* const PANEL_NAMES[PANELS] = { "SSD1306", "SH1106" };
+
+static unsigned constexpr PAGES = OLED::BYTES_PER_SEG;
+
+// Bus bytes of a full frame, and of a region in a session of its own, from cell
+// column cBegin to cEnd and page pBegin to pEnd, replayed up front because the
+// model can only be driven by one thread.
+static unsigned full_bytes[PANELS];
+static unsigned region_bytes[PANELS][COLS][COLS][PAGES][PAGES];
+
+// Replay, returning the bus bytes. Bytes the controller wouldn't accept end the sweep.
+template <typename Controller, typename Send>
+static unsigned replay(Send send) {
+  auto& m = OLED::model<Controller>();
+  m.reset_counts();
+  send();
+  if (m.violations) {
+    fprintf(stderr, "illegal flush: %s\n", m.first_violation.c_str());
+    exit(1);
+  }
+  return m.bytes;
+}
+
+template <typename Controller>
+static void replayAll(Panel panel) {
+  using Device = OLED::ModelDevice<Controller>;
+  using Flush = RoomFlush<Device, Blank>;
+  full_bytes[panel] = replay<Controller>([] {
+    uint8_t step = 0;
+    Flush::display(step);
+  });
+  for (uint8_t cBegin = 0; cBegin < COLS; ++cBegin) {
+    for (uint8_t cEnd = cBegin; cEnd < COLS; ++cEnd) {
+      for (uint8_t pBegin = 0; pBegin < PAGES; ++pBegin) {
+        for (uint8_t pEnd = pBegin; pEnd < PAGES; ++pEnd) {
+          region_bytes[panel][cBegin][cEnd][pBegin][pEnd] = replay<Controller>([=] {
+            OLED::Session<Device> session(20);
+            Flush::region(session, cBegin * X_PER_COL, cEnd * X_PER_COL + X_PER_COL - 1, pBegin, pEnd);
+            session.stop();
+          });
+        }
+      }
+    }
+  }
+}
+
+// The region of whole cells covering the ball at both positions, as refreshRegions() has it.
+static unsigned ballRegionBytes(Panel panel, Ball const& shown, Ball const& ball) {
+  uint8_t const xMin = std::min(shown.x, ball.x);
+  uint8_t const xMax = std::max(shown.x, ball.x) + X_PER_COL - 1;
+  uint8_t const yMin = std::min(shown.y, ball.y);
+  uint8_t const yMax = std::max(shown.y, ball.y) + Y_PER_ROW - 1;
+  return region_bytes[panel][xMin / X_PER_COL][xMax / X_PER_COL][yMin / 8][yMax / 8];
+}
+
+static bool fits(uint8_t y, uint8_t x) {
+  for (unsigned dy = 0; dy < Y_PER_ROW; ++dy) {
+    for (unsigned dx = 0; dx < X_PER_COL; ++dx) {
+      if (getWall((y + dy) / Y_PER_ROW, (x + dx) / X_PER_COL)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static uint32_t key(Ball const& b) {
+  return uint32_t(b.y) << 16 | uint32_t(b.x) << 8 | uint8_t(b.yDir + 8) << 4 | uint8_t(b.xDir + 8);
+}
+
+// Display bytes the ball gets composed into: its pixel columns times the pages it straddles.
+static unsigned composeBytes(Ball const& b) {
+  return X_PER_COL * ((b.y + Y_PER_ROW - 1) / 8 - b.y / 8 + 1);
+}
+
+struct Result {
+  Ball start;
+  bool trapped;
+  unsigned steps;   // before being trapped or entering the orbit
+  unsigned period;  // of the orbit
+  unsigned worst_compose;
+  unsigned long total_compose;
+  unsigned worst_bus[PANELS][STRATEGIES];
+  unsigned long total_bus[PANELS][STRATEGIES];
+  unsigned frames;
+};
+
+static void countBus(Result& r, Panel panel, Strategy strategy, unsigned bytes) {
+  r.worst_bus[panel][strategy] = std::max(r.worst_bus[panel][strategy], bytes);
+  r.total_bus[panel][strategy] += bytes;
+}
+
+static Result follow(Ball ball, WallMap walls) {
+  Result r {};
+  r.start = ball;
+  std::unordered_map<uint32_t, unsigned> seen;
+  for (unsigned step = 0;; ++step) {
+    auto const inserted = seen.emplace(key(ball), step);
+    if (!inserted.second) {
+      r.steps = inserted.first->second;
+      r.period = step - inserted.first->second;
+      return r;
+    }
+    unsigned const compose = composeBytes(ball);
+    r.worst_compose = std::max(r.worst_compose, compose);
+    r.total_compose += compose;
+    r.frames += 1;
+    Ball const shown = ball;
+    if (!move(ball, walls)) {
+      r.trapped = true;
+      r.steps = step;
+      return r;
+    }
+    for (unsigned p = 0; p < PANELS; ++p) {
+      countBus(r, Panel(p), FULL, full_bytes[p]);
+      countBus(r, Panel(p), BALL_REGION, ballRegionBytes(Panel(p), shown, ball));
+    }
+  }
+}
+
+int main() {
+  replayAll<OLED::SSD1306>(SSD1306);
+  replayAll<OLED::SH1106>(SH1106);
+  std::vector<Ball> starts;
+  for (unsigned y = 0; y + Y_PER_ROW <= ROWS * Y_PER_ROW; ++y) {
+    for (unsigned x = 0; x + X_PER_COL <= COLS * X_PER_COL; ++x) {
+      if (fits(y, x)) {
+        for (int8_t yDir : Y_DIRS) {
+          for (int8_t xDir : X_DIRS) {
+            starts.push_back(Ball { uint8_t(y), uint8_t(x), yDir, xDir });
+          }
+        }
+      }
+    }
+  }
+
+  WallMap walls;
+  walls.reset();
+  std::vector<Result> results(starts.size());
+  unsigned const threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (size_t i = t; i < starts.size(); i += threads) {
+        results[i] = follow(starts[i], walls);
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  std::vector<Result const*> trapped;
+  unsigned max_steps = 0, max_period = 0, worst_compose = 0;
+  unsigned long total_steps = 0, total_period = 0, total_compose = 0, frames = 0;
+  unsigned worst_bus[PANELS][STRATEGIES] = {};
+  unsigned long total_bus[PANELS][STRATEGIES] = {};
+  unsigned long moves = 0;
+  for (auto const& r : results) {
+    if (r.trapped) {
+      trapped.push_back(&r);
+    } else {
+      max_period = std::max(max_period, r.period);
+      total_period += r.period;
+    }
+    max_steps = std::max(max_steps, r.steps);
+    total_steps += r.steps;
+    worst_compose = std::max(worst_compose, r.worst_compose);
+    total_compose += r.total_compose;
+    for (unsigned p = 0; p < PANELS; ++p) {
+      for (unsigned f = 0; f < STRATEGIES; ++f) {
+        worst_bus[p][f] = std::max(worst_bus[p][f], r.worst_bus[p][f]);
+        total_bus[p][f] += r.total_bus[p][f];
+      }
+    }
+    frames += r.frames;
+    moves += r.frames - r.trapped;
+  }
+  unsigned long const orbits = results.size() - trapped.size();
+
+  printf("{\n");
+  printf("  \"room_shape\": {\n");
+  printf("    \"starts\": %zu,\n", results.size());
+  printf("    \"steps_to_orbit\": { \"max\": %u, \"average\": %.2f },\n",
+         max_steps, results.empty() ? 0. : double(total_steps) / results.size());
+  printf("    \"orbit_period\": { \"max\": %u, \"average\": %.2f },\n",
+         max_period, orbits ? double(total_period) / orbits : 0.);
+  printf("    \"compose_bytes_per_frame\": { \"worst\": %u, \"average\": %.3f },\n",
+         worst_compose, frames ? double(total_compose) / frames : 0.);
+  printf("    \"bus_bytes_per_frame\": {\n");
+  for (unsigned p = 0; p < PANELS; ++p) {
+    printf("      \"%s\": {", PANEL_NAMES[p]);
+    for (unsigned f = 0; f < STRATEGIES; ++f) {
+      printf("%s \"%s\": { \"worst\": %u, \"average\": %.2f }", f ? "," : "", STRATEGY_NAMES[f],
+             worst_bus[p][f], moves ? double(total_bus[p][f]) / moves : 0.);
+    }
+    printf(" }%s\n", p + 1 < PANELS ? "," : "");
+  }
+  printf("    },\n");
+  printf("    \"trapped\": [");
+  for (size_t i = 0; i < trapped.size(); ++i) {
+    Ball const& b = trapped[i]->start;
+    printf("%s\n      { \"y\": %u, \"x\": %u, \"yDir\": %d, \"xDir\": %d, \"after\": %u }",
+           i ? "," : "", b.y, b.x, b.yDir, b.xDir, trapped[i]->steps);
+  }
+  printf("%s]\n", trapped.empty() ? "" : "\n    ");
+  printf("  }\n");
+  printf("}\n");
+  return 0;
+}
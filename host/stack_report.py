@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""Worst-case stack usage per call chain of the sketch, computed at build time.
+
+Combines the frame size of each function, reported by gcc's -fstack-usage in
+.su files, with the call graph disassembled from the linked program. Every
+call adds the return address it pushes. Interrupt handlers are reported
+separately, and they may strike at the deepest point of the main chain.
+
+Build with stack usage reports, then point this script at the build directory:
+    arduino-cli compile --build-path build \\
+        --build-property compiler.cpp.extra_flags=-fstack-usage
+    host/stack_report.py build
+"""
+import glob
+import os
+import re
+import subprocess
+import sys
+
+RETURN_ADDRESS = 2  # bytes pushed by call/rcall on an ATtiny85
+ROOTS = ("main",)
+
+CALL = re.compile(r"\s(r?call|r?jmp)\s.*<([^>+]+)>")
+FUNCTION = re.compile(r"^[0-9a-f]+ <([^>]+)>:")
+
+
+def base_name(name):
+    """Strip return type and parameters from a function name, keeping the qualified name."""
+    depth = 0
+    for i, ch in enumerate(name):
+        if ch == "<":
+            depth += 1
+        elif ch == ">":
+            depth -= 1
+        elif ch == "(" and depth == 0:
+            name = name[:i]
+            break
+    return name.rsplit(" ", 1)[-1]
+
+
+def read_frames(build_dir):
+    frames = {}
+    for path in glob.glob(os.path.join(build_dir, "**", "*.su"), recursive=True):
+        with open(path) as f:
+            for line in f:
+                location, size, _kind = line.rstrip("\n").split("\t")
+                name = base_name(location.split(":", 3)[-1])
+                frames[name] = max(frames.get(name, 0), int(size))
+    return frames
+
+
+def read_calls(elf, objdump):
+    calls = {}
+    tail_calls = {}
+    current = None
+    listing = subprocess.run([objdump, "-d", "-C", elf], check=True,
+                             capture_output=True, text=True).stdout
+    for line in listing.splitlines():
+        m = FUNCTION.match(line)
+        if m:
+            current = base_name(m.group(1))
+            calls.setdefault(current, set())
+            tail_calls.setdefault(current, set())
+            continue
+        m = CALL.search(line)
+        if m and current:
+            callee = base_name(m.group(2))
+            if callee == current:
+                continue  # a loop, or genuine recursion, which the sketch doesn't do
+            (calls if m.group(1).endswith("call") else tail_calls)[current].add(callee)
+    # Jumps within a function show up as jumps to the function itself; those to
+    # the start of other functions are tail calls.
+    return calls, tail_calls
+
+
+def worst(name, frames, calls, tail_calls, seen=()):
+    """Return (bytes, chain) of the deepest stack use starting from name."""
+    if name in seen:
+        return 0, [name + " (recursion)"]
+    seen = seen + (name,)
+    best = (0, [])
+    for callee in calls.get(name, ()):
+        depth, chain = worst(callee, frames, calls, tail_calls, seen)
+        best = max(best, (depth + RETURN_ADDRESS, chain))
+    own = frames.get(name, 0)
+    best = (best[0] + own, [name] + best[1])
+    for callee in tail_calls.get(name, ()):
+        best = max(best, worst(callee, frames, calls, tail_calls, seen))
+    return best
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    build_dir = sys.argv[1]
+    objdump = os.environ.get("OBJDUMP", "avr-objdump")
+    elfs = glob.glob(os.path.join(build_dir, "*.elf"))
+    if not elfs:
+        sys.exit("no .elf in " + build_dir)
+    frames = read_frames(build_dir)
+    calls, tail_calls = read_calls(elfs[0], objdump)
+
+    unknown = sorted(f for f in calls if f not in frames and f[:2] != "__")
+    roots = [r for r in ROOTS if r in calls]
+    isrs = sorted(f for f in calls if f.startswith("__vector_"))
+
+    print("root,bytes,chain")
+    worst_main = 0
+    for root in roots:
+        depth, chain = worst(root, frames, calls, tail_calls)
+        worst_main = max(worst_main, depth)
+        print("%s,%d,%s" % (root, depth, " > ".join(chain)))
+    worst_isr = 0
+    for isr in isrs:
+        depth, chain = worst(isr, frames, calls, tail_calls)
+        worst_isr = max(worst_isr, depth + RETURN_ADDRESS)
+        print("%s,%d,%s" % (isr, depth + RETURN_ADDRESS, " > ".join(chain)))
+    print("total,%d,main and deepest interrupt" % (worst_main + worst_isr))
+    if unknown:
+        print("# no frame size known for: " + ", ".join(unknown), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,104 @@
+// Decodes the telemetry stream of the sketch into CSV lines on stdout,
+// and with -s, a summary of each second's worth of records on stderr.
+//
+// Build: g++ -O2 -std=c++11 -o telemetry_decode telemetry_decode.cpp
+// Use:   stty -F /dev/ttyUSB0 9600 raw && ./telemetry_decode -s < /dev/ttyUSB0
+#include "TelemetryDecoder.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+using namespace Telemetry;
+
+static unsigned u16(uint8_t const* p) {
+  return p[0] | p[1] << 8;
+}
+
+struct Summary {
+  unsigned frames = 0;
+  unsigned long move_us = 0;
+  unsigned long display_us = 0;
+  unsigned long bus_bytes = 0;
+  unsigned long transactions = 0;
+  unsigned long restarts = 0;
+  unsigned failures = 0;
+  unsigned bad_records = 0;
+
+  void print(double seconds) const {
+    fprintf(stderr, "%.1f frames/s", frames / seconds);
+    if (frames) {
+      fprintf(stderr, ", move %lu µs, display %lu µs, %lu bytes/frame, %.1f transactions/frame, %.1f restarts/frame",
+              move_us / frames, display_us / frames, bus_bytes / frames,
+              double(transactions) / frames, double(restarts) / frames);
+    }
+    fprintf(stderr, ", %u I2C failures, %u bad records\n", failures, bad_records);
+  }
+};
+
+// Print a good record as a CSV line, and add it to the summary.
+static void print(uint8_t kind, uint8_t const* p, Summary& summary) {
+  switch (kind) {
+    case FRAME:
+      printf("frame,%u,%u,%u,%u,%u,%u\n", u16(p), u16(p + 2), u16(p + 4), u16(p + 6), u16(p + 8), u16(p + 10));
+      summary.frames += 1;
+      summary.move_us += u16(p + 2);
+      summary.display_us += u16(p + 4);
+      summary.bus_bytes += u16(p + 6);
+      summary.transactions += u16(p + 8);
+      summary.restarts += u16(p + 10);
+      break;
+    case STATUS:
+      printf("status,%u,%u,,,,\n", p[0], p[1]);
+      summary.failures += 1;
+      break;
+    case BUS:
+      printf("bus,%u,%u,%u,%u,,\n", u16(p), u16(p + 2), u16(p + 4), u16(p + 6));
+      break;
+    case ANIMATION:
+      printf("animation,%u,%u,%u,,,\n", u16(p), u16(p + 2), u16(p + 4));
+      break;
+    case SCENE:
+      printf("scene,%u,%u,%u,,,\n", u16(p), u16(p + 2), u16(p + 4));
+      break;
+    case REGION:
+      // achieved refreshes per second, against the target
+      printf("region,%u,%u,%u,%u,%u,%.2f\n", p[0], p[1], u16(p + 2), u16(p + 4), u16(p + 6),
+             u16(p + 6) ? u16(p + 4) * 1000.0 / u16(p + 6) : 0.0);
+      break;
+    case GEOMETRY:
+      printf("geometry,%u,%u,%u,,,\n", p[0], p[1], u16(p + 2));
+      break;
+    case WALLS:
+      printf("walls,%.1f,%.1f,%.1f,,,\n", u16(p) / 10.0, u16(p + 2) / 10.0, u16(p + 4) / 10.0);
+      break;
+    case MEMORY:
+      printf("memory,%u,%u,%u,,,\n", u16(p), u16(p + 2), u16(p + 4));
+      break;
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  bool const summarize = argc > 1 && strcmp(argv[1], "-s") == 0;
+  Summary summary;
+  time_t summary_start = time(nullptr);
+
+  puts("kind,a,b,c,d,e,f");
+  Decoder decoder;
+  int c;
+  while ((c = getchar()) != EOF) {
+    decoder.put(uint8_t(c), [&summary](uint8_t kind, uint8_t const* p) {
+      print(kind, p, summary);
+    });
+    summary.bad_records += decoder.bad_records;
+    decoder.bad_records = 0;
+
+    time_t const now = time(nullptr);
+    if (summarize && now > summary_start) {
+      summary.print(double(now - summary_start));
+      summary = Summary();
+      summary_start = now;
+    }
+  }
+  return 0;
+}
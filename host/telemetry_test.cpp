@@ -0,0 +1,177 @@
+// Runs the telemetry of Telemetry.h on the host: records are queued as in the
+// sketch, the Timer1 interrupt handler is called once per bit time to shift
+// them out on the pin, the line is sampled into bytes like a serial port would,
+// and those go through the decoder of telemetry_decode. Also checks that the
+// decoder finds its way back to the records after junk on the line.
+//
+// Build: g++ -O2 -std=c++11 -D__AVR_ATtiny85__ -DF_CPU=8000000UL -I. -I.. -o telemetry_test telemetry_test.cpp
+#include "../Telemetry.h"
+#include "TelemetryDecoder.h"
+#include <stdio.h>
+#include <vector>
+
+using namespace Telemetry;
+using Bytes = std::vector<uint8_t>;
+
+static unsigned failures = 0;
+
+static void check(bool ok, char const* what) {
+  if (!ok) {
+    printf("failed: %s\n", what);
+    ++failures;
+  }
+}
+
+static bool line() {
+  return PORTB >> Telemetry::PIN & 1;
+}
+
+// Call the interrupt handler while it's enabled, and sample the line after each call.
+static void drain(std::vector<bool>& bits) {
+  while (TIMSK & (1 << OCIE1A)) {
+    TIMER1_COMPA_vect();
+    bits.push_back(line());
+  }
+}
+
+// Receive 8N1 from one sample per bit, counting bytes without a stop bit.
+static Bytes receive(std::vector<bool> const& bits, unsigned& framing_errors) {
+  Bytes bytes;
+  for (size_t i = 0; i < bits.size(); ++i) {
+    if (bits[i]) {
+      continue; // idle
+    }
+    if (i + 9 >= bits.size()) {
+      ++framing_errors;
+      break;
+    }
+    uint8_t b = 0;
+    for (unsigned bit = 0; bit < 8; ++bit) {
+      b |= uint8_t(bits[i + 1 + bit]) << bit;
+    }
+    if (!bits[i + 9]) {
+      ++framing_errors;
+    }
+    bytes.push_back(b);
+    i += 9;
+  }
+  return bytes;
+}
+
+// A record as the decoder hands it over: kind followed by payload.
+static std::vector<Bytes> decode(Bytes const& bytes, unsigned& bad_records) {
+  std::vector<Bytes> records;
+  Decoder decoder;
+  for (uint8_t b : bytes) {
+    decoder.put(b, [&records](uint8_t kind, uint8_t const* payload) {
+      Bytes record { kind };
+      record.insert(record.end(), payload, payload + payloadSize(kind));
+      records.push_back(record);
+    });
+  }
+  bad_records = decoder.bad_records;
+  return records;
+}
+
+static Bytes recordOf(Kind kind, std::vector<uint8_t> payload) {
+  payload.insert(payload.begin(), kind);
+  return payload;
+}
+
+// What the sketch sends, one record at a time so that each fits the queue.
+static std::vector<Bytes> sendSome(std::vector<bool>& bits) {
+  std::vector<Bytes> sent;
+  I2C::Traffic const traffic { 3, 1, 1030 };
+  sendFrame(0x1234, 250, 9000, traffic);
+  sent.push_back(recordOf(FRAME, { 0x34, 0x12, 250, 0, 0x28, 0x23, 0x06, 0x04, 3, 0, 1, 0 }));
+  drain(bits);
+  sendStatus(I2C::Status { 2, 0xA5 }); // a payload byte looking like SYNC
+  sent.push_back(recordOf(STATUS, { 2, 0xA5 }));
+  drain(bits);
+  sendRegion(1, 4, 250, 3, 1000);
+  sent.push_back(recordOf(REGION, { 1, 4, 250, 0, 3, 0, 0xE8, 0x03 }));
+  drain(bits);
+  sendGeometry(4, 8, 0x0102);
+  sent.push_back(recordOf(GEOMETRY, { 4, 8, 2, 1 }));
+  drain(bits);
+  sendBus(1, 1, 700);
+  sent.push_back(recordOf(BUS, { 1, 0, 1, 0, 0xBC, 0x02, 0, 0 }));
+  drain(bits);
+  sendMemory(300, 90, 100);
+  sent.push_back(recordOf(MEMORY, { 44, 1, 90, 0, 100, 0 }));
+  drain(bits);
+  sendAnimation(600, 1100, 40);
+  sent.push_back(recordOf(ANIMATION, { 0x58, 0x02, 0x4C, 0x04, 40, 0 }));
+  drain(bits);
+  sendScene(5, 1030, 300);
+  sent.push_back(recordOf(SCENE, { 5, 0, 0x06, 0x04, 0x2C, 0x01 }));
+  drain(bits);
+  sendWalls(183, 151, 97);
+  sent.push_back(recordOf(WALLS, { 183, 0, 151, 0, 97, 0 }));
+  drain(bits);
+  return sent;
+}
+
+// The bytes of a record on the line.
+static Bytes framed(Bytes const& record) {
+  Bytes bytes { SYNC };
+  uint8_t sum = 0;
+  for (uint8_t b : record) {
+    bytes.push_back(b);
+    sum += b;
+  }
+  bytes.push_back(uint8_t(-sum));
+  return bytes;
+}
+
+int main() {
+  begin();
+  check(line(), "line idles high");
+
+  std::vector<bool> bits;
+  std::vector<Bytes> const sent = sendSome(bits);
+  check(line(), "line back to idle after the records");
+  unsigned framing_errors = 0;
+  Bytes const bytes = receive(bits, framing_errors);
+  check(framing_errors == 0, "every byte has its stop bit");
+  Bytes expected_bytes;
+  for (Bytes const& record : sent) {
+    Bytes const f = framed(record);
+    expected_bytes.insert(expected_bytes.end(), f.begin(), f.end());
+  }
+  check(bytes == expected_bytes, "bytes on the line are the records queued");
+  unsigned bad_records = 0;
+  check(decode(bytes, bad_records) == sent, "records decode as sent");
+  check(bad_records == 0, "no bad records on a clean line");
+
+  // Junk before and between the same records: noise, a record cut short by
+  // a reset, and a SYNC followed by a valid kind, which swallows the start of
+  // the record after it until its checksum fails.
+  Bytes const noise { 0x00, 0xFF, 0x13, SYNC, 0x00 };
+  Bytes const cut_short(expected_bytes.begin(), expected_bytes.begin() + 7);
+  Bytes const false_start { SYNC, FRAME, 0x01 };
+  Bytes junky = noise;
+  for (size_t r = 0; r < sent.size(); ++r) {
+    Bytes const& junk = r == 0 ? cut_short : r == 1 ? false_start : noise;
+    junky.insert(junky.end(), junk.begin(), junk.end());
+    Bytes const f = framed(sent[r]);
+    junky.insert(junky.end(), f.begin(), f.end());
+  }
+  check(decode(junky, bad_records) == sent, "records decode as sent after junk");
+  check(bad_records > 0, "junk counts as bad records");
+
+  // A full queue drops whole records and counts them.
+  std::vector<bool> more;
+  I2C::Traffic const traffic {};
+  for (unsigned i = 0; i < 3; ++i) {
+    sendFrame(i, 0, 0, traffic);
+  }
+  check(dropped == 1, "the record that doesn't fit is dropped");
+  drain(more);
+  Bytes const fitted = receive(more, framing_errors);
+  check(decode(fitted, bad_records).size() == 2, "the records that fit come through");
+  check(bad_records == 0, "no bad records after dropping");
+
+  printf("%zu bits, %zu bytes, %u failures\n", bits.size() + more.size(), bytes.size() + fitted.size(), failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// Runs the I2C timing tuner of TimingTuner.h against a simulated slave, which
+// needs each delay of the bus to last a given number of cycles, and checks
+// that the tuner finds each of those limits on its own.
+// The USI routines that wait on the delays are replaced by ones that hand
+// the delays to the slave, in the order USI_TWI_Master.hpp waits on them.
+//
+// Build: g++ -O2 -std=c++11 -D__AVR_ATtiny85__ -DF_CPU=8000000UL -I. -I.. -o timing_tuner_test timing_tuner_test.cpp
+#include "../TimingTuner.h"
+#include <stdio.h>
+
+// Minimum timing in standard mode (100 kHz), long enough for tuning steps
+// of 10% to be more than a few cycles apart.
+struct StandardModeTiming {
+  static constexpr USI_TWI_Delay tHSTART { 4.0 };
+  static constexpr USI_TWI_Delay tSSTOP { 4.0 };
+  static constexpr USI_TWI_Delay tIDLE { 4.7 };
+  static constexpr USI_TWI_Delay tPRE_SCL_HIGH { 4.7 };
+  static constexpr USI_TWI_Delay tPOST_SCL_HIGH { 4.0 };
+  static constexpr USI_TWI_Delay tPOST_TRANSFER { 1.0 };
+};
+
+struct SimPanel {
+  using Controller = OLED::SSD1306;
+  static constexpr uint8_t ADDRESS { 0x3C };
+};
+
+using Tuner = OLED::TimingTuner<SimPanel, StandardModeTiming>;
+using Device = Tuner::Device;
+
+// A slave that misses a start condition held too briefly, loses track of
+// a byte clocked too fast, and when a stop condition or the bus free time
+// after it is too short, misses the start that follows. Having missed
+// something, it stops acknowledging until the next start it notices.
+static struct {
+  unsigned long needs[Tuner::DELAYS]; // cycles
+  bool settled = true;
+  bool listening = false;
+  unsigned long bytes = 0;
+} slave;
+
+static bool lasts(USI_TWI_Variable_Delay const& delay, Tuner::Delay d) {
+  return delay.in_cycles() >= slave.needs[d];
+}
+
+template <>
+USI_TWI_ErrorLevel USI_TWI_Master_Start<Device>() {
+  slave.listening = slave.settled && lasts(Device::tHSTART, Tuner::HSTART);
+  return USI_TWI_OK;
+}
+
+template <>
+USI_TWI_ErrorLevel USI_TWI_Master_Transmit<Device>(unsigned char msg, bool isAddress) {
+  // 8 bits, each with a low and a high clock period, then the same for the acknowledgement.
+  bool const clocked = lasts(Device::tPRE_SCL_HIGH, Tuner::PRE_SCL_HIGH) &&
+                       lasts(Device::tPOST_SCL_HIGH, Tuner::POST_SCL_HIGH) &&
+                       lasts(Device::tPOST_TRANSFER, Tuner::POST_TRANSFER);
+  slave.listening = slave.listening && clocked && (!isAddress || msg >> 1 == Device::ADDRESS);
+  if (!slave.listening) {
+    return isAddress ? USI_TWI_NO_ACK_ON_ADDRESS : USI_TWI_NO_ACK_ON_DATA;
+  }
+  ++slave.bytes;
+  return USI_TWI_OK;
+}
+
+template <>
+USI_TWI_ErrorLevel USI_TWI_Master_Stop<Device>() {
+  slave.settled = lasts(Device::tSSTOP, Tuner::SSTOP) && lasts(Device::tIDLE, Tuner::IDLE);
+  slave.listening = false;
+  return USI_TWI_OK;
+}
+
+void USI_TWI_Master_Initialise() {}
+
+static char const* const NAMES[Tuner::DELAYS] = {
+  "tHSTART", "tSSTOP", "tIDLE", "tPRE_SCL_HIGH", "tPOST_SCL_HIGH", "tPOST_TRANSFER",
+};
+
+// The lowest percentage, in steps down from 100, at which delay d still lasts long enough.
+static uint8_t expected(uint8_t d) {
+  uint8_t percent = 100;
+  while (percent >= Tuner::STEP) {
+    USI_TWI_Variable_Delay delay;
+    delay.set(Tuner::SPEC[d] * (percent - Tuner::STEP) / 100);
+    if (delay.in_cycles() < slave.needs[d]) {
+      break;
+    }
+    percent -= Tuner::STEP;
+  }
+  return percent;
+}
+
+// Tune against a slave needing the given cycles, and compare with what's expected.
+static unsigned check(char const* name, unsigned long const (&needs)[Tuner::DELAYS], bool copes) {
+  for (uint8_t d = 0; d < Tuner::DELAYS; ++d) {
+    slave.needs[d] = needs[d];
+  }
+  slave.settled = true;
+  uint8_t percents[Tuner::DELAYS];
+  bool const tuned = Tuner::tune(4, percents);
+  unsigned failures = 0;
+  if (tuned != copes) {
+    printf("%s: tuned %d, expected %d\n", name, tuned, copes);
+    return 1;
+  }
+  for (uint8_t d = 0; d < Tuner::DELAYS; ++d) {
+    // Without coping, all delays are left at the specification.
+    uint8_t const want = copes ? expected(d) : 100;
+    if (percents[d] != want) {
+      printf("%s: %s at %u%%, expected %u%%\n", name, NAMES[d], percents[d], want);
+      ++failures;
+    }
+    USI_TWI_Variable_Delay delay;
+    delay.set(Tuner::SPEC[d] * want / 100);
+    if (Tuner::delay(d).in_cycles() != delay.in_cycles()) {
+      printf("%s: %s left at %lu cycles, expected %lu\n",
+             name, NAMES[d], Tuner::delay(d).in_cycles(), delay.in_cycles());
+      ++failures;
+    }
+  }
+  // With the delays left as tuned, the slave must acknowledge everything.
+  if (copes && Tuner::errors(4) != 0) {
+    printf("%s: errors with the tuned delays\n", name);
+    ++failures;
+  }
+  return failures;
+}
+
+int main() {
+  for (uint8_t d = 0; d < Tuner::DELAYS; ++d) {
+    printf("%s: %lu cycles by the specification\n", NAMES[d], Tuner::SPEC[d]);
+  }
+  unsigned failures = 0;
+  unsigned long const lenient[Tuner::DELAYS] = { 0, 0, 0, 0, 0, 0 };
+  failures += check("lenient", lenient, true);
+  // Each delay with a different limit, so that mixing them up shows.
+  unsigned long const picky[Tuner::DELAYS] = { 20, 9, 30, 14, 25, 3 };
+  failures += check("picky", picky, true);
+  // Only one delay that can't be cut at all, while the others can.
+  unsigned long const stiff[Tuner::DELAYS] = { 0, 0, 0, Tuner::SPEC[Tuner::PRE_SCL_HIGH], 0, 0 };
+  failures += check("stiff", stiff, true);
+  // A slave too slow for the specification.
+  unsigned long const sluggish[Tuner::DELAYS] = { 0, 0, 0, 0, Tuner::SPEC[Tuner::POST_SCL_HIGH] + 8, 0 };
+  failures += check("sluggish", sluggish, false);
+  printf("%lu bytes acknowledged, %u failures\n", slave.bytes, failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,4 @@
+#pragma once
+// Stand-in for avr-libc's: a host program has no interrupts to block.
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(type) for (bool atomic_once = true; atomic_once; atomic_once = false)
@@ -0,0 +1,8 @@
+#pragma once
+// Stand-in for avr-libc's: there are no cycles to wait on a host, neither in
+// 4-cycle loops nor through avr-gcc's builtin.
+#include <stdint.h>
+
+#define __builtin_avr_delay_cycles(cycles) ((void)(cycles))
+
+inline void _delay_loop_2(uint16_t) {}
@@ -0,0 +1,41 @@
+; The functions host/lookup_cycles.py compiles from Room.h, written out in LLVM IR,
+; for counting cycles with LLVM's AVR backend where there's no avr-g++:
+;     llc -O2 -mtriple=avr -mcpu=attiny85 -o - host/wall_lookups.ll | host/lookup_cycles.py -
+; Keep them in step with getWall() and WallMap in Room.h.
+target datalayout = "e-P1-p:16:8-i8:8-i16:8-i32:8-i64:8-f32:8-f64:8-n8-a:8"
+target triple = "avr"
+
+%WallMap = type { [64 x i8], [4 x { i8, i8 }], i8 }
+
+@room_shape = internal addrspace(1) constant [512 x i8] zeroinitializer
+@walls = global %WallMap zeroinitializer
+@BIT = internal constant [16 x i8] c"\01\02\04\08\10\20\40\80\01\02\04\08\10\20\40\80"
+
+; getWall(row, col) != 0: pgm_read_byte(&room_shape[row * COLS + col]), in int, with COLS = 32
+define zeroext i1 @progmemLookup(i8 %row, i8 %col) addrspace(1) nounwind optsize {
+  %r = zext i8 %row to i16
+  %m = shl nuw nsw i16 %r, 5
+  %c = zext i8 %col to i16
+  %i = add nuw nsw i16 %m, %c
+  %p = getelementptr inbounds [512 x i8], [512 x i8] addrspace(1)* @room_shape, i16 0, i16 %i
+  %v = load i8, i8 addrspace(1)* %p
+  %nz = icmp ne i8 %v, 0
+  ret i1 %nz
+}
+
+; walls(row, col): bits[index(row, col)] & bit(row), with index(row, col) an
+; uint8_t of col * BYTES_PER_COL + (row >> 3), BYTES_PER_COL = 2
+define zeroext i1 @mapLookup(i8 %row, i8 %col) addrspace(1) nounwind optsize {
+  %c2 = shl i8 %col, 1
+  %rh = lshr i8 %row, 3
+  %i8 = add i8 %c2, %rh
+  %i = zext i8 %i8 to i16
+  %p = getelementptr inbounds %WallMap, %WallMap* @walls, i16 0, i32 0, i16 %i
+  %b = load i8, i8* %p
+  %r = zext i8 %row to i16
+  %q = getelementptr inbounds [16 x i8], [16 x i8]* @BIT, i16 0, i16 %r
+  %m = load i8, i8* %q
+  %a = and i8 %b, %m
+  %nz = icmp ne i8 %a, 0
+  ret i1 %nz
+}
@@ -0,0 +1,250 @@
+// Checks how WallMap in Room.h knocks down walls: only inner walls, each once,
+// each queued once for redrawing, never more than the queue holds, and never
+// without being queued, so that no wall disappears without being redrawn.
+// Also checks every move from every start, and a long game with walls being
+// knocked down, against what the walls were before and after.
+//
+// Build: g++ -O2 -std=c++11 -D__AVR_ATtiny85__ -DF_CPU=8000000UL -I. -I.. -o wall_map_test wall_map_test.cpp
+#include "../Room.h"
+#include <stdio.h>
+#include <vector>
+
+static int8_t const DIRS[] = { -2, -1, +1, +2 };
+
+static unsigned failures = 0;
+
+static void fail(char const* what, unsigned row, unsigned col) {
+  printf("%s at row %u, column %u\n", what, row, col);
+  ++failures;
+}
+
+// The cells queued as changed, emptying the queue.
+static std::vector<Cell> drain(WallMap& walls) {
+  std::vector<Cell> cells;
+  Cell cell;
+  while (walls.changed(cell)) {
+    cells.push_back(cell);
+    if (cells.size() > WallMap::MAX_CHANGES) {
+      fail("queue overflowing", cell.row, cell.col);
+      break;
+    }
+  }
+  return cells;
+}
+
+// Every inner wall, in room order.
+static std::vector<Cell> innerWalls() {
+  std::vector<Cell> cells;
+  for (uint8_t row = 0; row < ROWS; ++row) {
+    for (uint8_t col = 0; col < COLS; ++col) {
+      if (getWall(row, col) == 2) {
+        cells.push_back(Cell { row, col });
+      }
+    }
+  }
+  return cells;
+}
+
+// Check that the cells that went from wall to space between before and after
+// are those queued, each once, and that only inner walls went.
+static void checkChanges(WallMap const& before, WallMap const& after, std::vector<Cell> const& queued) {
+  for (uint8_t row = 0; row < ROWS; ++row) {
+    for (uint8_t col = 0; col < COLS; ++col) {
+      bool const knocked_down = before(row, col) && !after(row, col);
+      if (!before(row, col) && after(row, col)) {
+        fail("wall appearing", row, col);
+      }
+      if (knocked_down && getWall(row, col) != 2) {
+        fail("not an inner wall knocked down", row, col);
+      }
+      unsigned times = 0;
+      for (Cell const& cell : queued) {
+        times += cell.row == row && cell.col == col;
+      }
+      if (times != (knocked_down ? 1 : 0)) {
+        printf("queued %u times: ", times);
+        fail(knocked_down ? "wall knocked down" : "wall standing", row, col);
+      }
+    }
+  }
+}
+
+static void hits() {
+  WallMap walls;
+  walls.reset();
+  for (uint8_t row = 0; row < ROWS; ++row) {
+    for (uint8_t col = 0; col < COLS; ++col) {
+      if (walls(row, col) != (getWall(row, col) != 0)) {
+        fail("reset differing from room_shape", row, col);
+      }
+    }
+  }
+
+  // An inner wall goes once, and is queued once.
+  Cell const inner = innerWalls().front();
+  WallMap before = walls;
+  walls.hit(inner.row, inner.col);
+  walls.hit(inner.row, inner.col);
+  checkChanges(before, walls, drain(walls));
+  before = walls;
+  walls.hit(inner.row, inner.col);
+  checkChanges(before, walls, drain(walls));
+
+  // The outer wall and space don't change.
+  before = walls;
+  walls.hit(0, 0);
+  walls.hit(ROWS - 1, COLS / 2);
+  walls.hit(1, 1);
+  checkChanges(before, walls, drain(walls));
+
+  // With a full queue, a wall stays until its change can be queued.
+  std::vector<Cell> const cells = innerWalls();
+  before = walls;
+  for (uint8_t i = 1; i <= WallMap::MAX_CHANGES + 1; ++i) {
+    walls.hit(cells[i].row, cells[i].col);
+  }
+  Cell const last = cells[WallMap::MAX_CHANGES + 1];
+  if (!walls(last.row, last.col)) {
+    fail("wall knocked down with a full queue", last.row, last.col);
+  }
+  checkChanges(before, walls, drain(walls));
+  before = walls;
+  walls.hit(last.row, last.col);
+  checkChanges(before, walls, drain(walls));
+
+  // Forgetting changes, as after displaying the whole room, empties the queue
+  // but leaves the walls knocked down.
+  Cell const forgotten = cells[WallMap::MAX_CHANGES + 2];
+  walls.hit(forgotten.row, forgotten.col);
+  walls.forget_changes();
+  if (!drain(walls).empty()) {
+    fail("changes remembered after forgetting", forgotten.row, forgotten.col);
+  }
+  if (walls(forgotten.row, forgotten.col)) {
+    fail("wall standing again after forgetting", forgotten.row, forgotten.col);
+  }
+}
+
+static bool fits(WallMap const& walls, Ball const& ball) {
+  for (unsigned dy = 0; dy < Y_PER_ROW; ++dy) {
+    for (unsigned dx = 0; dx < X_PER_COL; ++dx) {
+      if (walls((ball.y + dy) / Y_PER_ROW, (ball.x + dx) / X_PER_COL)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Every move from every start where the ball fits, with all walls standing.
+// Returns the moves knocking down the most walls.
+static std::vector<Ball> moves(WallMap const& room, unsigned& most) {
+  std::vector<Ball> busiest;
+  most = 0;
+  for (uint8_t y = 0; y + Y_PER_ROW <= ROWS * Y_PER_ROW; ++y) {
+    for (uint8_t x = 0; x + X_PER_COL <= COLS * X_PER_COL; ++x) {
+      for (int8_t yDir : DIRS) {
+        for (int8_t xDir : DIRS) {
+          Ball ball { y, x, yDir, xDir };
+          if (!fits(room, ball)) {
+            continue;
+          }
+          WallMap walls = room;
+          move(ball, walls, true);
+          std::vector<Cell> const queued = drain(walls);
+          checkChanges(room, walls, queued);
+          if (queued.size() > most) {
+            most = queued.size();
+            busiest.clear();
+          }
+          if (queued.size() == most) {
+            busiest.push_back(Ball { y, x, yDir, xDir });
+          }
+        }
+      }
+    }
+  }
+  return busiest;
+}
+
+// Cells standing in before but not in after.
+static unsigned knockedDown(WallMap const& before, WallMap const& after) {
+  unsigned count = 0;
+  for (uint8_t row = 0; row < ROWS; ++row) {
+    for (uint8_t col = 0; col < COLS; ++col) {
+      count += before(row, col) && !after(row, col);
+    }
+  }
+  return count;
+}
+
+// Moves knocking down walls one after the other, without draining the queue
+// in between, until one has more walls to knock down than the queue has room.
+static void fill(WallMap const& room, std::vector<Ball> const& busiest) {
+  WallMap walls = room;
+  unsigned queued = 0;
+  bool held_back = false;
+  for (Ball const& start : busiest) {
+    // What the move would knock down with an empty queue.
+    WallMap empty = walls;
+    empty.forget_changes();
+    Ball ball = start;
+    move(ball, empty, true);
+    unsigned const would = knockedDown(walls, empty);
+
+    WallMap const before = walls;
+    ball = start;
+    move(ball, walls, true);
+    unsigned const did = knockedDown(before, walls);
+    unsigned const room_left = WallMap::MAX_CHANGES - queued;
+    if (did != (would < room_left ? would : room_left)) {
+      printf("%u of %u walls knocked down with room for %u: ", did, would, room_left);
+      fail("move", start.y / Y_PER_ROW, start.x / X_PER_COL);
+    }
+    queued += did;
+    if (would > did) {
+      held_back = true;
+      break;
+    }
+  }
+  if (!held_back) {
+    fail("queue never filled up", 0, 0);
+  }
+  std::vector<Cell> const cells = drain(walls);
+  if (cells.size() != WallMap::MAX_CHANGES) {
+    fail("queue not full", 0, 0);
+  }
+  checkChanges(room, walls, cells);
+}
+
+// A long game, draining the queue after each move as refreshRegions() does.
+static void game(WallMap const& room) {
+  WallMap walls = room;
+  Ball ball { 10 * Y_PER_ROW, 7 * X_PER_COL, +1, -2 };
+  unsigned knocked_down = 0;
+  for (unsigned step = 0; step < 1000000; ++step) {
+    WallMap const before = walls;
+    if (!move(ball, walls, true)) {
+      printf("trapped after %u moves\n", step);
+      ++failures;
+      return;
+    }
+    std::vector<Cell> const queued = drain(walls);
+    checkChanges(before, walls, queued);
+    knocked_down += queued.size();
+  }
+  printf("%u of %zu inner walls knocked down in a game\n", knocked_down, innerWalls().size());
+}
+
+int main() {
+  hits();
+  WallMap room;
+  room.reset();
+  unsigned most;
+  std::vector<Ball> const busiest = moves(room, most);
+  printf("at most %u walls knocked down by a move, from %zu starts\n", most, busiest.size());
+  fill(room, busiest);
+  game(room);
+  printf("%u failures\n", failures);
+  return failures == 0 ? 0 : 1;
+}